@@ -0,0 +1,350 @@
+// Size-adaptive execution policy: adaptive::auto_policy, accepted by wrappers of the algorithms this repository
+// benchmarks, runs each call with seq, unseq or par, whichever was fastest for inputs of its size on this machine.
+// For small arrays the parallel policies are often many times slower than serial ones, and the size from which they
+// win depends on the algorithm, the element type, the machine and the thread count.
+//
+// The first call of an algorithm for an element type calibrates it: each policy is timed at every power of two size
+// from 2^adaptive_min_log to 2^adaptive_max_log elements (the fastest of a few runs), and the fastest one is kept per
+// size class. Calls then look up the class of their size, in O(1); sizes beyond the calibrated range use the nearest
+// class. Calibrations are kept per thread limit (tbb::global_control), so --threads sweeps calibrate again.
+//
+//     size_t n = adaptive::count(adaptive::auto_policy, v.begin(), v.end(), 42);
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <execution>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#if __has_include(<tbb/global_control.h>)
+#include <tbb/global_control.h>
+#endif
+
+#include "counter_random.h"
+
+namespace adaptive
+{
+
+struct auto_policy_t {};
+inline constexpr auto_policy_t auto_policy{};
+
+enum Choice { CHOICE_SEQ, CHOICE_UNSEQ, CHOICE_PAR };
+
+inline const char* choice_name(Choice choice)
+{
+    switch (choice)
+    {
+    case CHOICE_SEQ:   return "seq";
+    case CHOICE_UNSEQ: return "unseq";
+    default:           return "par";
+    }
+}
+
+const int adaptive_min_log = 8;
+const int adaptive_max_log = 22;
+
+// Fastest policy per power of two size class
+struct Calibration
+{
+    Choice best[adaptive_max_log + 1] = {};
+
+    Choice choose(size_t n) const
+    {
+        int log = 0;
+        while (log < adaptive_max_log && ((size_t)2 << log) <= n)
+            log++;
+        return best[std::max(log, adaptive_min_log)];
+    }
+
+    // For example "seq below 4096, unseq below 65536, par from 65536"
+    std::string description() const
+    {
+        std::string text;
+        for (int log = adaptive_min_log; log <= adaptive_max_log; )
+        {
+            int end = log;      // size classes [log, end] share a choice
+            while (end < adaptive_max_log && best[end + 1] == best[log])
+                end++;
+            text += (text.empty() ? "" : ", ") + std::string(choice_name(best[log]));
+            if (end < adaptive_max_log)
+                text += " below " + std::to_string((size_t)2 << end);
+            else if (log > adaptive_min_log)
+                text += " from " + std::to_string((size_t)1 << log);
+            else
+                text += " at all sizes";
+            log = end + 1;
+        }
+        return text;
+    }
+};
+
+inline volatile size_t sink;       // results of calibration runs, so they are not optimized away
+
+template <class T> const char* type_name()            { return typeid(T).name(); }
+template <>        inline const char* type_name<int>()       { return "int"; }
+template <>        inline const char* type_name<long long>() { return "long long"; }
+template <>        inline const char* type_name<float>()     { return "float"; }
+template <>        inline const char* type_name<double>()    { return "double"; }
+
+// Every calibration made so far, for example "count<int> at 8 threads: seq below 16384, par from 16384"
+inline std::vector<std::string>& calibration_log()
+{
+    static std::vector<std::string> log;
+    return log;
+}
+
+inline size_t thread_limit()
+{
+#if __has_include(<tbb/global_control.h>)
+    return tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism);
+#else
+    return std::max(std::thread::hardware_concurrency(), 1u);
+#endif
+}
+
+// Runs function with the execution policy of choice. Without unseq (Microsoft's library), unseq runs as seq
+template <class Function>
+auto with_policy(Choice choice, Function function)
+{
+    switch (choice)
+    {
+    case CHOICE_SEQ:   return function(std::execution::seq);
+#ifndef MICROSOFT_ALGORITHMS
+    case CHOICE_UNSEQ: return function(std::execution::unseq);
+#else
+    case CHOICE_UNSEQ: return function(std::execution::seq);
+#endif
+    default:           return function(std::execution::par);
+    }
+}
+
+// Calibration workloads. Each fills the input array once, then runs its algorithm over n elements of input and work,
+// where work starts as a copy of input. Algorithms that change work in a way that changes the next run (sort) reset
+// it before every run. Those whose speed depends on the values (sort, max_element, min_element) get uniform random
+// numbers of counter_random.h, like the benchmark inputs: on structured sequences the policies cross over elsewhere
+const uint64_t calibration_seed = 1234;
+
+template <class T> T random_input(size_t i) { return random_value<T>(random_at(calibration_seed, i)); }
+
+struct CountAlgorithm
+{
+    static constexpr const char* name = "count";
+    static const bool resets = false;
+    template <class T> static T value(size_t i) { return (T)(i % 16); }
+    template <class T, class Policy> static void run(Policy&& policy, T* input, T*, size_t n) { sink = (size_t)std::count(policy, input, input + n, (T)1); }
+};
+
+struct MaxElementAlgorithm
+{
+    static constexpr const char* name = "max_element";
+    static const bool resets = false;
+    template <class T> static T value(size_t i) { return random_input<T>(i); }
+    template <class T, class Policy> static void run(Policy&& policy, T* input, T*, size_t n) { sink = (size_t)(std::max_element(policy, input, input + n) - input); }
+};
+
+struct MinElementAlgorithm
+{
+    static constexpr const char* name = "min_element";
+    static const bool resets = false;
+    template <class T> static T value(size_t i) { return random_input<T>(i); }
+    template <class T, class Policy> static void run(Policy&& policy, T* input, T*, size_t n) { sink = (size_t)(std::min_element(policy, input, input + n) - input); }
+};
+
+struct AdjacentFindAlgorithm
+{
+    static constexpr const char* name = "adjacent_find";
+    static const bool resets = false;
+    template <class T> static T value(size_t i) { return (T)i; }     // no equal neighbors: every element is compared
+    template <class T, class Policy> static void run(Policy&& policy, T* input, T*, size_t n) { sink = (size_t)(std::adjacent_find(policy, input, input + n) - input); }
+};
+
+struct AdjacentDifferenceAlgorithm
+{
+    static constexpr const char* name = "adjacent_difference";
+    static const bool resets = false;
+    template <class T> static T value(size_t i) { return (T)(i % 1000); }
+    template <class T, class Policy> static void run(Policy&& policy, T* input, T* work, size_t n) { std::adjacent_difference(policy, input, input + n, work); sink = (size_t)work[n / 2]; }
+};
+
+struct CopyAlgorithm
+{
+    static constexpr const char* name = "copy";
+    static const bool resets = false;
+    template <class T> static T value(size_t i) { return (T)i; }
+    template <class T, class Policy> static void run(Policy&& policy, T* input, T* work, size_t n) { std::copy(policy, input, input + n, work); sink = (size_t)work[n / 2]; }
+};
+
+struct FillAlgorithm
+{
+    static constexpr const char* name = "fill";
+    static const bool resets = false;
+    template <class T> static T value(size_t) { return (T)0; }
+    template <class T, class Policy> static void run(Policy&& policy, T*, T* work, size_t n) { std::fill(policy, work, work + n, (T)42); sink = (size_t)work[n / 2]; }
+};
+
+struct EqualAlgorithm
+{
+    static constexpr const char* name = "equal";
+    static const bool resets = false;
+    template <class T> static T value(size_t i) { return (T)i; }     // equal arrays: every element is compared
+    template <class T, class Policy> static void run(Policy&& policy, T* input, T* work, size_t n) { sink = (size_t)std::equal(policy, input, input + n, work); }
+};
+
+struct SortAlgorithm
+{
+    static constexpr const char* name = "sort";
+    static const bool resets = true;
+    template <class T> static T value(size_t i) { return random_input<T>(i); }
+    template <class T, class Policy> static void run(Policy&& policy, T*, T* work, size_t n) { std::sort(policy, work, work + n); sink = (size_t)work[n / 2]; }
+};
+
+// Times every policy at every size class, keeping the fastest. The policies take turns over several rounds, so that
+// drifting conditions (frequency, other load) affect them alike, and each keeps its fastest time. Runs of small sizes
+// are batched to take a measurable time
+template <class Algorithm, class T>
+Calibration calibrate()
+{
+    const size_t max_n = (size_t)1 << adaptive_max_log;
+    std::vector<T> input(max_n), work(max_n);
+    for (size_t i = 0; i < max_n; i++)
+        input[i] = Algorithm::template value<T>(i);
+    std::copy(std::execution::par, input.begin(), input.end(), work.begin());
+
+    std::vector<Choice> choices = { CHOICE_SEQ, CHOICE_UNSEQ, CHOICE_PAR };
+#ifdef MICROSOFT_ALGORITHMS
+    choices.erase(choices.begin() + 1);
+#endif
+    Calibration calibration;
+    for (int log = adaptive_min_log; log <= adaptive_max_log; log++)
+    {
+        const size_t n     = (size_t)1 << log;
+        const size_t batch = std::max((size_t)1 << 16 >> log, (size_t)1);
+        double fastest[3] = {}, spent = 0.0;
+        for (int round = 0; round < 7 && (round < 2 || spent < 0.05); round++)
+        {
+            for (Choice choice : choices)
+            {
+                double seconds = 0.0;
+                for (size_t b = 0; b < batch; b++)
+                {
+                    if (Algorithm::resets)
+                        std::copy(input.begin(), input.begin() + n, work.begin());
+                    auto start = std::chrono::steady_clock::now();
+                    with_policy(choice, [&](auto&& policy) { Algorithm::run(policy, input.data(), work.data(), n); return 0; });
+                    seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                }
+                spent += seconds;
+                seconds /= (double)batch;
+                if (round == 0 || seconds < fastest[choice])
+                    fastest[choice] = seconds;
+            }
+        }
+        calibration.best[log] = choices[0];     // seq, then unseq, then par, unless the next is faster by 3% or more
+        for (Choice choice : choices)
+            if (fastest[choice] < 0.97 * fastest[calibration.best[log]])
+                calibration.best[log] = choice;
+    }
+    return calibration;
+}
+
+// Calibration of an algorithm for an element type at the current thread limit, calibrating on first use. The last
+// one used is found without locking
+template <class Algorithm, class T>
+const Calibration& calibration()
+{
+    struct Entry { size_t threads; Calibration calibration; };
+    static std::atomic<const Entry*> latest{ nullptr };
+    static std::mutex                mutex;
+    static std::map<size_t, Entry>   by_thread_limit;
+
+    size_t       threads = thread_limit();
+    const Entry* entry   = latest.load(std::memory_order_acquire);
+    if (entry != nullptr && entry->threads == threads)
+        return entry->calibration;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = by_thread_limit.find(threads);
+    if (found == by_thread_limit.end())
+    {
+        found = by_thread_limit.emplace(threads, Entry{ threads, calibrate<Algorithm, T>() }).first;
+        calibration_log().push_back(std::string(Algorithm::name) + "<" + type_name<T>() + "> at " + std::to_string(threads) + " threads: " +
+            found->second.calibration.description());
+    }
+    latest.store(&found->second, std::memory_order_release);
+    return found->second.calibration;
+}
+
+template <class Algorithm, class Iterator>
+Choice choice_for(Iterator first, Iterator last)
+{
+    typedef typename std::iterator_traits<Iterator>::value_type T;
+    return calibration<Algorithm, T>().choose((size_t)(last - first));
+}
+
+// Wrappers, taking the arguments of the standard algorithms with auto_policy in place of the execution policy.
+// Iterators must be random access
+
+template <class Iterator, class T>
+typename std::iterator_traits<Iterator>::difference_type count(auto_policy_t, Iterator first, Iterator last, const T& value)
+{
+    return with_policy(choice_for<CountAlgorithm>(first, last), [&](auto&& policy) { return std::count(policy, first, last, value); });
+}
+
+template <class Iterator>
+Iterator max_element(auto_policy_t, Iterator first, Iterator last)
+{
+    return with_policy(choice_for<MaxElementAlgorithm>(first, last), [&](auto&& policy) { return std::max_element(policy, first, last); });
+}
+
+template <class Iterator>
+Iterator min_element(auto_policy_t, Iterator first, Iterator last)
+{
+    return with_policy(choice_for<MinElementAlgorithm>(first, last), [&](auto&& policy) { return std::min_element(policy, first, last); });
+}
+
+template <class Iterator>
+Iterator adjacent_find(auto_policy_t, Iterator first, Iterator last)
+{
+    return with_policy(choice_for<AdjacentFindAlgorithm>(first, last), [&](auto&& policy) { return std::adjacent_find(policy, first, last); });
+}
+
+template <class Iterator, class Output>
+Output adjacent_difference(auto_policy_t, Iterator first, Iterator last, Output result)
+{
+    return with_policy(choice_for<AdjacentDifferenceAlgorithm>(first, last), [&](auto&& policy) { return std::adjacent_difference(policy, first, last, result); });
+}
+
+template <class Iterator, class Output>
+Output copy(auto_policy_t, Iterator first, Iterator last, Output result)
+{
+    return with_policy(choice_for<CopyAlgorithm>(first, last), [&](auto&& policy) { return std::copy(policy, first, last, result); });
+}
+
+template <class Iterator, class T>
+void fill(auto_policy_t, Iterator first, Iterator last, const T& value)
+{
+    with_policy(choice_for<FillAlgorithm>(first, last), [&](auto&& policy) { std::fill(policy, first, last, value); return 0; });
+}
+
+template <class Iterator1, class Iterator2>
+bool equal(auto_policy_t, Iterator1 first1, Iterator1 last1, Iterator2 first2)
+{
+    return with_policy(choice_for<EqualAlgorithm>(first1, last1), [&](auto&& policy) { return std::equal(policy, first1, last1, first2); });
+}
+
+template <class Iterator>
+void sort(auto_policy_t, Iterator first, Iterator last)
+{
+    with_policy(choice_for<SortAlgorithm>(first, last), [&](auto&& policy) { std::sort(policy, first, last); return 0; });
+}
+
+}   // namespace adaptive
@@ -0,0 +1,389 @@
+// Allocator of the benchmark buffers. std::vector<int> data(array_size) value-initializes (zeroes) the whole array on
+// one thread, which also decides where its pages are placed: on the NUMA node of that thread. bench_vector<T> instead
+// default-initializes its elements (no zeroing of trivial types) and pages the memory in as selected by --page-in:
+//     none      pages are not touched when allocated. The first write, usually the serial setup of the benchmark, places them
+//     serial    one write per page from the allocating thread, placing all pages like value-initialization does (default)
+//     parallel  one write per page in the chunks of parallel_utils.h, so each page is first touched by the chunk of
+//               elements that the algorithms of this repository later process it in
+// On Linux every buffer is a fresh mmap, whatever its size, so its pages are untouched until paged in: operator new
+// would return heap memory already touched below the malloc mmap threshold (up to 32 MB). Elsewhere buffers come from
+// operator new, for which --page-in and --numa do not control first touch, as the run header reports.
+// Buffers are aligned to the page size, so pages are not shared between buffers.
+//
+// --pages selects the pages backing the buffers (Linux only):
+//     default   mmap with whatever the system transparent huge page setting gives
+//     4k        mmap with madvise(MADV_NOHUGEPAGE): base pages only, even when transparent huge pages are always on
+//     thp       mmap aligned to 2 MB with madvise(MADV_HUGEPAGE): transparent huge pages where the kernel can provide them
+//     2m, 1g    mmap with MAP_HUGETLB from the reserved hugetlbfs pool (/proc/sys/vm/nr_hugepages and
+//               /sys/kernel/mm/hugepages). When the pool is too small, falls back to the next smaller kind, down to 4k
+// The smallest kind the buffers of a run actually got is recorded with its results.
+//
+// --numa sets the NUMA memory policy of the buffers with mbind before they are paged in (Linux only):
+//     none        the policy of the process, usually allocation on the node of the thread that first touches a page
+//     local       bound to the node of the allocating (main) thread
+//     interleave  interleaved page by page over all nodes with memory
+//     firsttouch  explicitly on the node of the thread that first touches each page. Use with --page-in=parallel or none
+// On single-node machines every policy places all pages on the one node, as a no-op comparison.
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel_utils.h"
+#include "system_info.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#endif
+
+enum PageIn
+{
+    PAGE_IN_NONE,
+    PAGE_IN_SERIAL,
+    PAGE_IN_PARALLEL
+};
+
+inline const char* page_in_name(PageIn page_in)
+{
+    static const char* names[] = { "none", "serial", "parallel" };
+    return names[page_in];
+}
+
+inline bool parse_page_in(const std::string& name, PageIn& page_in)
+{
+    for (PageIn mode : { PAGE_IN_NONE, PAGE_IN_SERIAL, PAGE_IN_PARALLEL })
+    {
+        if (name == page_in_name(mode))
+        {
+            page_in = mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Pages backing the buffers, ordered from the smallest to the largest page
+enum PageKind
+{
+    PAGES_DEFAULT,
+    PAGES_4K,
+    PAGES_THP,
+    PAGES_2M,
+    PAGES_1G
+};
+
+inline const char* page_kind_name(PageKind pages)
+{
+    static const char* names[] = { "default", "4k", "thp", "2m", "1g" };
+    return names[pages];
+}
+
+inline bool parse_page_kind(const std::string& name, PageKind& pages)
+{
+    for (PageKind kind : { PAGES_DEFAULT, PAGES_4K, PAGES_THP, PAGES_2M, PAGES_1G })
+    {
+        if (name == page_kind_name(kind))
+        {
+            pages = kind;
+            return true;
+        }
+    }
+    return false;
+}
+
+enum NumaPolicy
+{
+    NUMA_NONE,
+    NUMA_LOCAL,
+    NUMA_INTERLEAVE,
+    NUMA_FIRST_TOUCH
+};
+
+inline const char* numa_policy_name(NumaPolicy numa)
+{
+    static const char* names[] = { "none", "local", "interleave", "firsttouch" };
+    return names[numa];
+}
+
+inline bool parse_numa_policy(const std::string& name, NumaPolicy& numa)
+{
+    for (NumaPolicy policy : { NUMA_NONE, NUMA_LOCAL, NUMA_INTERLEAVE, NUMA_FIRST_TOUCH })
+    {
+        if (name == numa_policy_name(policy))
+        {
+            numa = policy;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Placement of the buffers allocated by the running benchmark
+struct BufferPlacement
+{
+    PageIn     page_in = PAGE_IN_SERIAL;
+    PageKind   pages   = PAGES_DEFAULT;
+    NumaPolicy numa    = NUMA_NONE;
+};
+
+inline std::string placement_description(const BufferPlacement& placement)
+{
+    std::string description = std::string("page-in = ") + page_in_name(placement.page_in) + "  pages = " +
+                              page_kind_name(placement.pages) + "  numa = " + numa_policy_name(placement.numa);
+#ifndef __linux__
+    description += " (heap buffers: first touch not controlled)";
+#endif
+    return description;
+}
+
+inline BufferPlacement buffer_placement;
+inline PageKind        buffer_pages_obtained = PAGES_DEFAULT;  // smallest kind of pages allocated since reset_buffer_pages()
+
+inline size_t page_size()
+{
+#ifdef __linux__
+    static size_t size = (size_t)sysconf(_SC_PAGESIZE);
+    return size;
+#else
+    return 4096;
+#endif
+}
+
+inline size_t page_size_of(PageKind pages)
+{
+    switch (pages)
+    {
+    case PAGES_2M: return (size_t)2 << 20;
+    case PAGES_1G: return (size_t)1 << 30;
+    default:       return page_size();
+    }
+}
+
+inline void reset_buffer_pages()
+{
+    buffer_pages_obtained = buffer_placement.pages;
+}
+
+// Writes one byte of every page of a buffer of count elements, serially or in the chunks the parallel algorithms split
+// the elements into. A page is touched by the chunk its first byte falls in
+inline void page_in_buffer(void* buffer, size_t count, size_t element_size, PageIn page_in, size_t page)
+{
+    const size_t bytes = count * element_size;
+    if (page_in == PAGE_IN_NONE || bytes == 0)
+        return;
+    char* bytes_begin = static_cast<char*>(buffer);
+    if (page_in == PAGE_IN_SERIAL)
+    {
+        for (size_t offset = 0; offset < bytes; offset += page)
+            bytes_begin[offset] = 0;
+        return;
+    }
+    const size_t chunks = parallel_chunk_count(count, (size_t)1 << 16);
+    parallel_for_chunks(chunks, [&](size_t c)
+    {
+        auto bounds = chunk_bounds(count, chunks, c);
+        for (size_t offset = (bounds.first * element_size + page - 1) / page * page; offset < bounds.second * element_size; offset += page)
+            bytes_begin[offset] = 0;
+    });
+}
+
+// Mapping of a live buffer: the buffer may start past the beginning of the mapping, to align it to huge pages
+struct BufferMapping
+{
+    void*    base;
+    size_t   length;
+    PageKind pages;
+    bool     mapped;        // by mmap, otherwise by operator new
+    size_t   bytes;         // of the buffer itself
+};
+
+inline std::mutex                      buffer_mutex;
+inline std::map<void*, BufferMapping>  buffer_mappings;
+
+#ifdef __linux__
+// Maps bytes with the given kind of pages. Returns nullptr when the kind is not available
+inline void* map_pages(size_t bytes, PageKind pages, BufferMapping& mapping)
+{
+    const size_t huge = (size_t)2 << 20;
+    if (pages == PAGES_2M || pages == PAGES_1G)
+    {
+        size_t page   = page_size_of(pages);
+        int    log2   = pages == PAGES_2M ? 21 : 30;
+        size_t length = (bytes + page - 1) / page * page;
+        void*  base   = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (log2 << MAP_HUGE_SHIFT), -1, 0);
+        if (base == MAP_FAILED)
+            return nullptr;
+        mapping = { base, length, pages, true, bytes };
+        return base;
+    }
+    size_t length = pages == PAGES_THP ? bytes + huge : bytes;    // room to align the buffer to a huge page
+    void*  base   = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+        return nullptr;
+    char* buffer = static_cast<char*>(base);
+    if (pages == PAGES_THP)
+    {
+        buffer = reinterpret_cast<char*>(((uintptr_t)base + huge - 1) / huge * huge);
+        if (madvise(buffer, bytes, MADV_HUGEPAGE) != 0)
+            pages = PAGES_4K;
+    }
+    else if (pages == PAGES_4K)
+        madvise(buffer, bytes, MADV_NOHUGEPAGE);
+    mapping = { base, length, pages, true, bytes };
+    return buffer;
+}
+#endif
+
+// NUMA node of the CPU the calling thread runs on
+inline int current_numa_node()
+{
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    for (auto& node : numa_nodes())
+        if (std::find(node.cpus.begin(), node.cpus.end(), cpu) != node.cpus.end())
+            return node.id;
+#endif
+    return numa_nodes().front().id;
+}
+
+// Sets the memory policy of the pages of a mapping, before they are touched
+inline void bind_buffer(void* base, size_t length, NumaPolicy numa)
+{
+#ifdef __linux__
+    if (numa == NUMA_NONE)
+        return;
+    const int     mpol_bind = 2, mpol_interleave = 3, mpol_local = 4;
+    unsigned long nodes[1024 / (8 * sizeof(unsigned long))] = {};
+    const size_t  bits = 8 * sizeof(unsigned long);
+    int           mode = mpol_local;
+    if (numa == NUMA_LOCAL || numa == NUMA_INTERLEAVE)
+    {
+        mode = numa == NUMA_LOCAL ? mpol_bind : mpol_interleave;
+        for (auto& node : numa_nodes())
+            if ((numa == NUMA_INTERLEAVE || node.id == current_numa_node()) && (size_t)node.id < 1024)
+                nodes[node.id / bits] |= 1ul << (node.id % bits);
+    }
+    size_t page  = page_size();
+    char*  begin = reinterpret_cast<char*>((uintptr_t)base / page * page);
+    size_t bytes = ((char*)base + length - begin + page - 1) / page * page;
+    if (syscall(SYS_mbind, begin, bytes, mode, mode == mpol_local ? nullptr : nodes, mode == mpol_local ? 0 : 1024, 0) != 0)
+    {
+        static bool warned = false;
+        if (!warned)
+            fprintf(stderr, "NUMA policy %s could not be set: %s\n", numa_policy_name(numa), strerror(errno));
+        warned = true;
+    }
+#else
+    (void)base; (void)length; (void)numa;
+#endif
+}
+
+// Buffer of count elements of element_size bytes, placed and paged in as selected by buffer_placement
+inline void* allocate_buffer(size_t count, size_t element_size)
+{
+    size_t        bytes  = std::max(count * element_size, (size_t)1);
+    PageKind      pages  = buffer_placement.pages;
+    void*         buffer = nullptr;
+    BufferMapping mapping{ nullptr, bytes, PAGES_DEFAULT, false, bytes };
+#ifdef __linux__
+    for (int kind = pages; kind >= PAGES_4K && buffer == nullptr; kind--)
+        buffer = map_pages(bytes, (PageKind)kind, mapping);
+    if (buffer == nullptr && pages == PAGES_DEFAULT)
+        buffer = map_pages(bytes, PAGES_DEFAULT, mapping);
+    if (buffer == nullptr)
+        throw std::bad_alloc();
+#else
+    buffer  = ::operator new(bytes, std::align_val_t(page_size()));
+    mapping = { buffer, bytes, pages == PAGES_DEFAULT ? PAGES_DEFAULT : PAGES_4K, false, bytes };
+#endif
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex);
+        buffer_mappings[buffer] = mapping;
+        if (mapping.pages < buffer_pages_obtained)
+        {
+            if (buffer_pages_obtained == buffer_placement.pages)
+                fprintf(stderr, "%s pages are not available, falling back to %s pages\n", page_kind_name(buffer_placement.pages), page_kind_name(mapping.pages));
+            buffer_pages_obtained = mapping.pages;
+        }
+    }
+    bind_buffer(mapping.mapped ? mapping.base : buffer, mapping.mapped ? mapping.length : bytes, buffer_placement.numa);
+    page_in_buffer(buffer, count, element_size, buffer_placement.page_in, page_size_of(mapping.pages));
+    return buffer;
+}
+
+inline void free_buffer(void* buffer, size_t /*bytes*/) noexcept
+{
+    BufferMapping mapping;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex);
+        auto found = buffer_mappings.find(buffer);
+        if (found == buffer_mappings.end())
+            return;
+        mapping = found->second;
+        buffer_mappings.erase(found);
+    }
+#ifdef __linux__
+    if (mapping.mapped)
+    {
+        munmap(mapping.base, mapping.length);
+        return;
+    }
+#endif
+    ::operator delete(buffer, std::align_val_t(page_size()));
+}
+
+template <class T>
+class BenchmarkAllocator
+{
+public:
+    typedef T value_type;
+
+    BenchmarkAllocator() noexcept {}
+    template <class U> BenchmarkAllocator(const BenchmarkAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(allocate_buffer(count, sizeof(T)));
+    }
+
+    void deallocate(T* buffer, size_t count) noexcept
+    {
+        free_buffer(buffer, count * sizeof(T));
+    }
+
+    // Default-initialize instead of value-initialize: elements of trivial types are left as they are
+    template <class U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value)
+    {
+        ::new (static_cast<void*>(p)) U;
+    }
+
+    template <class U, class... Args>
+    void construct(U* p, Args&&... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template <class T, class U> bool operator==(const BenchmarkAllocator<T>&, const BenchmarkAllocator<U>&) noexcept { return true;  }
+template <class T, class U> bool operator!=(const BenchmarkAllocator<T>&, const BenchmarkAllocator<U>&) noexcept { return false; }
+
+template <class T>
+using bench_vector = std::vector<T, BenchmarkAllocator<T>>;
@@ -0,0 +1,1301 @@
+// Benchmark harness: registry of benchmarks and command-line selection of benchmarks, policies, sizes and repetitions.
+//
+// Every *_benchmark(array_size, num_times) function registers into the registry in main(). The command line then picks
+// which of them run, at which array sizes, how many times, and for which execution policies. For example:
+//     benchmark_parallel_std --filter=sort --policy=par,par_unseq --size=1e6..1e9 --reps=10
+// runs every benchmark whose name contains "sort", only the parallel policies, at sizes 1e6, 1e7, 1e8 and 1e9.
+//
+// Each repetition loop reports its time through print_results(), which feeds the statistics engine below. Warm-up
+// repetitions are run but not recorded, and when a confidence interval target is given, repetitions are added until
+// the 95% confidence interval of the mean is within the target (or --max-reps is reached). When a loop ends, the
+// min/median/p95/mean/stddev and coefficient of variation of its samples are printed, after rejecting outliers
+// outside of Tukey's fences (1.5 inter-quartile ranges beyond the quartiles).
+//
+// Sweep mode (--sweep) runs each benchmark over log-spaced working set sizes from L1-sized to multi-GB. Each size is
+// annotated with the cache level its working set fits in, and the size where the fastest parallel policy starts
+// beating the fastest serial policy is reported for each algorithm.
+//
+// Thread sweeps (--threads=1,2,4 or --threads=sweep) limit the TBB backend of the parallel policies with
+// tbb::global_control and report the speedup and parallel efficiency of each parallel policy versus its run at the
+// smallest thread count. Serial policies run only once, at the first thread count.
+//
+// Each benchmark declares the bytes its algorithm reads and writes per element, from which the achieved bandwidth of
+// the median time is reported. With --bandwidth, the STREAM-style baselines (registered as stream_*) run first, and the
+// best bandwidth they reach is the attainable bandwidth each result is reported as a percentage of.
+//
+// The timed region of each repetition is delimited by start_timer() and stop_timer(). With --counters, hardware
+// performance counters of all threads are read around it (see perf_counters.h) and reported per run of each policy.
+//
+// Benchmark buffers are bench_vector (see benchmark_allocator.h), paged in as selected by --page-in, backed by the
+// pages selected by --pages and placed on NUMA nodes as selected by --numa. Each combination is a separate run of the
+// benchmark, with its own crossover and thread scaling reports. --pin pins the threads to CPUs (see thread_pinning.h).
+//
+// Resident mode (--resident=L2) reuses one buffer sized to half of a cache level for many back-to-back repetitions
+// (100 unless --reps is given), the way a request handler calls an algorithm on a small hot buffer. The caches are
+// evicted before the first repetition of each policy, and the first run is reported against the steady state (the
+// median of the last half of the repetitions), with the repetition from which the times stay near the steady state.
+//
+// --cache=warm,flush,evict selects the state of the caches before every repetition, as separate runs: warm leaves them
+// as the previous repetition left them, flush flushes the benchmark buffers from all caches, and evict streams through
+// a buffer larger than the last level cache (see cache_eviction.h). Both happen outside of the timed region. --cold
+// is short for --cache=evict.
+//
+// --match=0,1,50,none places the first match (or mismatch) of the search benchmarks, such as all_of and equal, at these
+// percentages of the array, as separate runs, where by default there is none and the searches scan the whole array.
+// After the runs, each policy's time at every position is reported against its full scan, to show how soon it stops.
+//
+// --dist=uniform,sorted,zipf:1.2 runs the sort and merge benchmarks on each input distribution, and --merge-ratio=1:1,1:9
+// the merge benchmarks with their inputs split in each proportion (see input_generators.h). After the runs, the
+// algorithms of each distribution are ranked by median time, as the fastest one often changes with the distribution.
+//
+// Results can be written with --json or --csv (see results_output.h), and two such files compared with --compare
+// (see results_compare.h) to detect regressions between compilers, library versions or machines.
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "benchmark_allocator.h"
+#include "cache_eviction.h"
+#include "input_generators.h"
+#include "perf_counters.h"
+#include "system_info.h"
+#include "thread_pinning.h"
+
+#if __has_include(<tbb/global_control.h>)
+#include <tbb/global_control.h>
+#define BENCHMARK_THREAD_CONTROL
+#endif
+
+typedef void (*BenchmarkFunction)(size_t array_size, size_t num_times);
+
+// Inputs of a benchmark that are varied by command line options, each value a separate run
+enum BenchmarkInputs
+{
+    INPUTS_FIXED        = 0,
+    INPUTS_MATCH        = 1,    // the position of the first match of a search, by --match
+    INPUTS_DISTRIBUTION = 2,    // the distribution of the values, by --dist
+    INPUTS_MERGE_RATIO  = 4     // the proportion of the sizes of two merge inputs, by --merge-ratio
+};
+
+struct BenchmarkEntry
+{
+    const char*       name;
+    BenchmarkFunction run;
+    size_t            bytes_per_element;    // working set of the timed region per element of array_size
+    size_t            bytes_read;           // bytes the algorithm reads per element of array_size
+    size_t            bytes_written;        // bytes the algorithm writes per element of array_size
+    bool              run_by_default;       // run when no --filter is given
+    unsigned          inputs;               // BenchmarkInputs varied per run
+    bool              cache_control;        // caches brought to the --cache state before each timed region. false for
+                                            // benchmarks that set up the caches themselves, which run only warm
+};
+
+struct BenchmarkOptions
+{
+    std::vector<std::string> filters;       // substrings of benchmark names to run. Empty runs the default set
+    std::vector<std::string> policies;      // seq, unseq, par, par_unseq, auto. Empty runs all of them
+    std::vector<size_t>      sizes  = { 100'000'000 };     // empty in resident mode, which sizes buffers to the cache level
+    std::vector<size_t>      threads;               // thread counts of parallel policies. Empty uses all hardware threads
+    std::vector<PageIn>      page_in = { PAGE_IN_SERIAL };  // page-in modes of the benchmark buffers, each run separately
+    std::vector<PageKind>    pages   = { PAGES_DEFAULT };   // pages backing the benchmark buffers, each run separately
+    std::vector<NumaPolicy>  numa    = { NUMA_NONE };       // NUMA policies of the benchmark buffers, each run separately
+    PinMode                  pin     = PIN_NONE;            // pinning of the threads to CPUs
+    size_t                   num_times = 5;
+    size_t                   warmup    = 0;         // repetitions run before samples are recorded
+    double                   ci_target = 0.0;       // relative half-width of the 95% confidence interval to reach. 0 disables
+    size_t                   max_reps  = 100;       // upper limit of repetitions when ci_target is set
+    bool                     quiet     = false;     // print only the statistics of each loop, not each sample
+    bool                     sweep     = false;     // run every benchmark over log-spaced working set sizes
+    size_t                   sweep_min = 0;         // smallest working set of the sweep in bytes. 0 is the L1 data cache size
+    size_t                   sweep_max = 4ull << 30;
+    size_t                   steps_per_decade = 0;  // sizes per decade of ranges and sweeps. 0 is 1 for ranges and 4 for sweeps
+    int                      resident_level = 0;    // cache level the buffers of resident mode fit into. 0 disables resident mode
+    std::vector<CacheState>  cache   = { CACHE_WARM };      // states of the caches before each repetition, each run separately
+    std::vector<double>      match   = { -1.0 };            // fractions of search arrays their first match is at, each run separately. < 0 is none
+    std::vector<InputDistribution> distributions = { InputDistribution() };  // of the sort and merge inputs, each run separately
+    std::vector<MergeRatio>  merge_ratios = { MergeRatio() };   // proportions of the merge input sizes, each run separately
+    bool                     bandwidth = false;     // measure the attainable bandwidth first, and report results relative to it
+    bool                     counters  = false;     // read hardware performance counters around the timed region
+    std::string              json_path;             // files to write results and the environment manifest to
+    std::string              csv_path;
+    std::string              command_line;
+    bool                     list_only = false;
+    std::string              compare_baseline;      // results files to compare instead of running benchmarks
+    std::string              compare_current;
+    double                   compare_threshold = 0.05;  // relative change of the median that counts as a regression or improvement
+    double                   compare_alpha     = 0.05;  // significance level of the Mann-Whitney U test
+};
+
+struct SampleStatistics
+{
+    size_t count    = 0;      // samples used, after outlier rejection
+    size_t outliers = 0;
+    double min      = 0.0;
+    double median   = 0.0;
+    double p95      = 0.0;
+    double mean     = 0.0;
+    double stddev   = 0.0;
+    double cv       = 0.0;    // coefficient of variation: stddev / mean
+    double ci95     = 0.0;    // half-width of the 95% confidence interval of the mean, relative to the mean
+};
+
+// Samples (in milliseconds) of one repetition loop: one (benchmark, tag, size) combination
+struct BenchmarkResult
+{
+    std::string         benchmark;
+    std::string         tag;
+    std::string         policy;
+    size_t              array_size;
+    size_t              threads;            // thread limit of parallel policies
+    std::string         page_in;            // how the buffers were paged in: none, serial or parallel
+    std::string         pages;              // pages of the buffers: default, 4k, thp, 2m or 1g, such as 2m->thp after a fallback
+    std::string         numa;               // NUMA policy of the buffers: none, local, interleave or firsttouch
+    std::string         cache;              // state of the caches before each repetition: warm, flush or evict
+    std::string         match;              // position of the first match of a search, such as 1% or none. Empty for other benchmarks
+    std::string         distribution;       // of the input values, such as uniform or zipf:1. Empty for benchmarks with fixed inputs
+    std::string         merge_ratio;        // of the merge input sizes, such as 1:1. Empty for benchmarks other than merges
+    size_t              working_set;        // bytes
+    size_t              bytes_moved;        // bytes read and written by one run of the algorithm
+    std::string         cache_level;        // smallest cache level the working set fits in
+    std::string         element_type;       // of the array, such as int or double
+    std::vector<double> samples;
+    SampleStatistics    stats;
+    PerfCounterValues   counters;           // sums over the recorded samples
+};
+
+inline std::vector<BenchmarkEntry>  benchmark_registry;
+inline BenchmarkOptions             benchmark_options;
+inline std::vector<BenchmarkResult> benchmark_results;
+inline double                       attainable_bandwidth = 0.0;    // GB/s of the STREAM-style baselines. 0 when not measured
+
+// State of the repetition loop currently running
+inline const BenchmarkEntry* current_benchmark = nullptr;
+inline size_t      current_array_size = 0;
+inline size_t      current_threads    = 0;
+inline bool        current_first_threads = true;    // running at the first thread count of a thread sweep
+inline bool        current_in_warmup  = false;
+inline bool        current_recording  = false;
+inline size_t      current_iteration  = 0;      // repetition of the running loop, counting warm-up repetitions
+inline CacheState  current_cache      = CACHE_WARM;
+inline double      current_match      = -1.0;   // fraction of the array the first match of a search is placed at. < 0 is none
+inline InputDistribution current_distribution;     // of the values of sort and merge inputs
+inline MergeRatio        current_merge_ratio;      // of the sizes of the two merge inputs
+
+inline PerfCounters      perf_counters;
+inline bool              perf_counters_open = false;
+inline PerfCounterValues current_counters;      // of the last timed region
+
+inline void register_benchmark(const char* name, BenchmarkFunction run, size_t bytes_per_element, size_t bytes_read, size_t bytes_written,
+    bool run_by_default = true, unsigned inputs = INPUTS_FIXED, bool cache_control = true)
+{
+    benchmark_registry.push_back({ name, run, bytes_per_element, bytes_read, bytes_written, run_by_default, inputs, cache_control });
+}
+
+// Name of a --match position: a percentage such as 1%, or none
+inline std::string match_name(double match)
+{
+    if (match < 0.0)
+        return "none";
+    char name[32];
+    snprintf(name, sizeof(name), "%g%%", 100.0 * match);
+    return name;
+}
+
+inline bool parse_match(std::string text, double& match)
+{
+    if (text == "none")
+    {
+        match = -1.0;
+        return true;
+    }
+    if (!text.empty() && text.back() == '%')
+        text.pop_back();
+    char*  end     = nullptr;
+    double percent = strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0' || percent < 0.0 || percent > 100.0)
+        return false;
+    match = percent / 100.0;
+    return true;
+}
+
+inline bool is_bandwidth_baseline(const BenchmarkEntry& entry)
+{
+    return strncmp(entry.name, "stream_", 7) == 0;
+}
+
+// Achieved bandwidth of a time in GB/s (10^9 bytes per second)
+inline double bandwidth_of(size_t bytes_moved, double time_ms)
+{
+    return time_ms > 0.0 ? (double)bytes_moved / (time_ms * 1e6) : 0.0;
+}
+
+// Execution policy of a result tag, derived from the naming convention used by all benchmarks:
+// "Serial ..." is seq, "Serial SIMD ..." or "SIMD ..." is unseq, "Parallel ..." is par, "Parallel SIMD ..." is par_unseq,
+// and "Adaptive ..." is auto (adaptive::auto_policy, which picks one of the others by size)
+inline const char* policy_of(const char* tag)
+{
+    if (strncmp(tag, "Adaptive",       8) == 0) return "auto";
+    if (strncmp(tag, "Parallel SIMD", 13) == 0) return "par_unseq";
+    if (strncmp(tag, "Parallel",       8) == 0) return "par";
+    if (strncmp(tag, "Serial SIMD",   11) == 0) return "unseq";
+    if (strncmp(tag, "SIMD",           4) == 0) return "unseq";
+    return "seq";
+}
+
+inline bool is_parallel(const std::string& policy)
+{
+    return policy == "par" || policy == "par_unseq" || policy == "auto";
+}
+
+inline bool policy_selected(const char* policy)
+{
+    if (benchmark_options.policies.empty())
+        return true;
+    for (auto& p : benchmark_options.policies)
+        if (p == policy)
+            return true;
+    return false;
+}
+
+inline bool benchmark_selected(const BenchmarkEntry& entry)
+{
+    if (benchmark_options.filters.empty())
+        return entry.run_by_default;
+    for (auto& f : benchmark_options.filters)
+        if (strstr(entry.name, f.c_str()) != nullptr)
+            return true;
+    return false;
+}
+
+// Statistics engine
+
+// Value at fraction p (0..1) of sorted samples, interpolating linearly between neighbors
+inline double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+    double position = p * (double)(sorted.size() - 1);
+    size_t below    = (size_t)position;
+    size_t above    = std::min(below + 1, sorted.size() - 1);
+    return sorted[below] + (position - (double)below) * (sorted[above] - sorted[below]);
+}
+
+// Two-sided 95% critical value of Student's t distribution
+inline double t_critical_95(size_t degrees_of_freedom)
+{
+    static const double table[] = { 0.0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                         2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                         2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+    if (degrees_of_freedom == 0)
+        return 0.0;
+    if (degrees_of_freedom <= 30)
+        return table[degrees_of_freedom];
+    return 1.96 + 2.4 / (double)degrees_of_freedom;    // approaches the normal distribution
+}
+
+inline SampleStatistics compute_statistics(const std::vector<double>& samples)
+{
+    SampleStatistics stats;
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+
+    if (sorted.size() >= 4)     // reject outliers outside of Tukey's fences
+    {
+        double q1    = percentile(sorted, 0.25);
+        double q3    = percentile(sorted, 0.75);
+        double fence = 1.5 * (q3 - q1);
+        std::vector<double> kept;
+        for (double s : sorted)
+            if (s >= q1 - fence && s <= q3 + fence)
+                kept.push_back(s);
+        stats.outliers = sorted.size() - kept.size();
+        sorted.swap(kept);
+    }
+    stats.count = sorted.size();
+    if (stats.count == 0)
+        return stats;
+
+    double sum = 0.0;
+    for (double s : sorted)
+        sum += s;
+    stats.mean = sum / (double)stats.count;
+
+    double sum_squares = 0.0;
+    for (double s : sorted)
+        sum_squares += (s - stats.mean) * (s - stats.mean);
+    stats.stddev = stats.count > 1 ? std::sqrt(sum_squares / (double)(stats.count - 1)) : 0.0;
+
+    stats.min    = sorted.front();
+    stats.median = percentile(sorted, 0.5);
+    stats.p95    = percentile(sorted, 0.95);
+    stats.cv     = stats.mean > 0.0 ? stats.stddev / stats.mean : 0.0;
+    stats.ci95   = stats.mean > 0.0 ? t_critical_95(stats.count - 1) * stats.stddev / std::sqrt((double)stats.count) / stats.mean : 0.0;
+    return stats;
+}
+
+// Hardware counters per run, and per element of the array
+inline void print_counters(const BenchmarkResult& result)
+{
+    const PerfCounterValues& c = result.counters;
+    double runs     = (double)result.samples.size();
+    double elements = (double)std::max(result.array_size, (size_t)1) * runs;
+    std::string text;
+    char item[96];
+    if (c.valid[PERF_CYCLES] && c.valid[PERF_INSTRUCTIONS] && c.values[PERF_CYCLES] > 0.0)
+    {
+        snprintf(item, sizeof(item), "  IPC: %.2f", c.values[PERF_INSTRUCTIONS] / c.values[PERF_CYCLES]);
+        text += item;
+    }
+    for (int event = 0; event < PERF_EVENT_COUNT; event++)
+    {
+        if (c.valid[event])
+            snprintf(item, sizeof(item), "  %s: %.4g/run %.4g/element", perf_event_name(event), c.values[event] / runs, c.values[event] / elements);
+        else
+            snprintf(item, sizeof(item), "  %s: n/a", perf_event_name(event));
+        text += item;
+    }
+    if (c.valid[PERF_CYCLES] && c.valid[PERF_STALLED_CYCLES] && c.values[PERF_CYCLES] > 0.0)
+    {
+        snprintf(item, sizeof(item), "  stalled: %.1f%%", 100.0 * c.values[PERF_STALLED_CYCLES] / c.values[PERF_CYCLES]);
+        text += item;
+    }
+    printf("%s: Counters (all threads):%s\n", result.tag.c_str(), text.c_str());
+}
+
+inline void print_statistics(const BenchmarkResult& result)
+{
+    const SampleStatistics& s = result.stats;
+    printf("%s: size = %zu  Threads: %zu  Samples: %zu  Outliers: %zu  Min: %fms  Median: %fms  P95: %fms  Mean: %fms  StdDev: %fms  CV: %.2f%%  CI95: +-%.2f%%\n",
+        result.tag.c_str(), result.array_size, result.threads, s.count, s.outliers, s.min, s.median, s.p95, s.mean,
+        s.stddev, 100.0 * s.cv, 100.0 * s.ci95);
+    if (result.bytes_moved > 0 && s.count > 0)
+    {
+        double bandwidth = bandwidth_of(result.bytes_moved, s.median);
+        if (attainable_bandwidth > 0.0)
+            printf("%s: Bandwidth: %.2f GB/s  %.1f%% of attainable %.2f GB/s\n", result.tag.c_str(), bandwidth, 100.0 * bandwidth / attainable_bandwidth, attainable_bandwidth);
+        else
+            printf("%s: Bandwidth: %.2f GB/s\n", result.tag.c_str(), bandwidth);
+    }
+    if (perf_counters_open && !result.samples.empty())
+        print_counters(result);
+}
+
+// Loop condition of each benchmark repetition loop. Skips the whole loop when the policy of the tag is not selected,
+// runs the warm-up repetitions, then at least num_times recorded repetitions, and more while the confidence interval
+// is wider than requested. Summarizes the samples when the loop ends.
+inline bool next_iteration(const char* tag, size_t i, size_t num_times)
+{
+    if (i == 0)
+    {
+        if (!policy_selected(policy_of(tag)))
+            return false;
+        if (!current_first_threads && !is_parallel(policy_of(tag)))
+            return false;       // serial policies do not depend on the thread count
+
+        BenchmarkResult result;
+        result.benchmark   = current_benchmark->name;
+        result.tag         = tag;
+        result.policy      = policy_of(tag);
+        result.array_size  = current_array_size;
+        result.threads     = is_parallel(result.policy) ? current_threads : 1;
+        result.page_in     = page_in_name(buffer_placement.page_in);
+        result.numa        = numa_policy_name(buffer_placement.numa);
+        result.cache       = cache_state_name(current_cache);
+        result.match       = current_benchmark->inputs & INPUTS_MATCH        ? match_name(current_match) : "";
+        result.distribution = current_benchmark->inputs & INPUTS_DISTRIBUTION ? distribution_name(current_distribution) : "";
+        result.merge_ratio = current_benchmark->inputs & INPUTS_MERGE_RATIO  ? merge_ratio_name(current_merge_ratio) : "";
+        result.working_set = current_array_size * current_benchmark->bytes_per_element;
+        result.cache_level = cache_level_of(result.working_set);
+        result.bytes_moved = current_array_size * (current_benchmark->bytes_read + current_benchmark->bytes_written);
+        benchmark_results.push_back(result);
+        current_recording = true;
+    }
+    BenchmarkResult& result = benchmark_results.back();
+
+    current_iteration = i;
+    current_in_warmup = i < benchmark_options.warmup;
+    if (i < benchmark_options.warmup + num_times)
+        return true;
+    if (benchmark_options.ci_target > 0.0 && result.samples.size() < benchmark_options.max_reps)
+    {
+        result.stats = compute_statistics(result.samples);
+        if (result.stats.count < 2 || result.stats.ci95 > benchmark_options.ci_target)
+            return true;
+    }
+
+    result.stats      = compute_statistics(result.samples);
+    current_recording = false;
+    print_statistics(result);
+    return false;
+}
+
+// Start and end of the timed region of a repetition. The caches are brought to the state of --cache before the clock
+// starts. In resident mode, warm caches are evicted before the first repetition of each loop. Benchmarks without
+// cache_control find the caches as they left them
+inline std::chrono::high_resolution_clock::time_point start_timer()
+{
+    if (current_benchmark == nullptr || current_benchmark->cache_control)
+    {
+        CacheState cache = current_cache;
+        if (cache == CACHE_WARM && benchmark_options.resident_level > 0 && current_recording && current_iteration == 0)
+            cache = CACHE_EVICT;
+        prepare_caches(cache);
+    }
+    if (perf_counters_open)
+    {
+        perf_counters.open();       // counters for threads created since the last repetition
+        perf_counters.start();
+    }
+    return std::chrono::high_resolution_clock::now();
+}
+
+inline std::chrono::high_resolution_clock::time_point stop_timer()
+{
+    auto now = std::chrono::high_resolution_clock::now();
+    if (perf_counters_open)
+        current_counters = perf_counters.stop();
+    return now;
+}
+
+// Records one sample of the running repetition loop. Returns false for warm-up repetitions and when samples are not
+// to be printed
+inline bool record_sample(const char* tag, double time_ms, const char* element_type)
+{
+    if (!current_recording || benchmark_results.back().tag != tag)
+        return true;        // not within a repetition loop
+    if (current_in_warmup)
+        return false;
+    BenchmarkResult& result = benchmark_results.back();
+    result.element_type = element_type;
+    result.pages        = page_kind_name(buffer_placement.pages);
+    if (buffer_pages_obtained != buffer_placement.pages)
+        result.pages += std::string("->") + page_kind_name(buffer_pages_obtained);     // fell back to smaller pages
+    result.samples.push_back(time_ms);
+    for (int event = 0; event < PERF_EVENT_COUNT; event++)
+    {
+        result.counters.values[event] += current_counters.values[event];
+        result.counters.valid[event]  |= current_counters.valid[event];
+    }
+    return !benchmark_options.quiet;
+}
+
+// Command line parsing
+
+inline std::vector<std::string> split_list(const std::string& list, char separator = ',')
+{
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t end = list.find(separator, start);
+        if (end == std::string::npos)
+            end = list.size();
+        if (end > start)
+            items.push_back(list.substr(start, end - start));
+        start = end + 1;
+    }
+    return items;
+}
+
+// Parses counts such as 100000000, 100'000'000, 1e8, 100M, 64K. Suffixes K, M, G are powers of unit: 1000 for
+// element counts and 1024 for bytes
+inline bool parse_count(std::string text, double& count, double unit = 1000.0)
+{
+    std::string digits;
+    for (char c : text)
+        if (c != '\'' && c != '_')
+            digits += c;
+    if (digits.empty())
+        return false;
+
+    double multiplier = 1.0;
+    switch (digits.back())
+    {
+    case 'k': case 'K': multiplier = unit;               digits.pop_back(); break;
+    case 'm': case 'M': multiplier = unit * unit;        digits.pop_back(); break;
+    case 'g': case 'G': multiplier = unit * unit * unit; digits.pop_back(); break;
+    }
+    char* end = nullptr;
+    double value = strtod(digits.c_str(), &end);
+    if (digits.empty() || *end != '\0' || value < 0.0)
+        return false;
+    count = value * multiplier;
+    return true;
+}
+
+// Sizes from low to high (inclusive), spaced evenly on a logarithmic scale with steps_per_decade sizes per decade
+inline std::vector<size_t> log_spaced_sizes(double low, double high, size_t steps_per_decade)
+{
+    std::vector<size_t> sizes;
+    double factor = std::pow(10.0, 1.0 / (double)steps_per_decade);
+    for (size_t step = 0; ; step++)
+    {
+        double size = low * std::pow(factor, (double)step);
+        if (size > high * (1.0 + 1e-9))
+            break;
+        size_t rounded = (size_t)std::llround(size);
+        if (sizes.empty() || sizes.back() != rounded)
+            sizes.push_back(rounded);
+    }
+    return sizes;
+}
+
+// Parses a comma separated list of sizes, where each item is a single size or a range "low..high" expanded into
+// steps_per_decade sizes per decade
+inline bool parse_sizes(const std::string& text, std::vector<size_t>& sizes, size_t steps_per_decade)
+{
+    sizes.clear();
+    for (auto& item : split_list(text))
+    {
+        size_t range = item.find("..");
+        double low, high;
+        if (range == std::string::npos)
+        {
+            if (!parse_count(item, low) || low < 1.0)
+                return false;
+            sizes.push_back((size_t)low);
+            continue;
+        }
+        if (!parse_count(item.substr(0, range), low) || !parse_count(item.substr(range + 2), high) || low < 1.0 || high < low)
+            return false;
+        for (size_t size : log_spaced_sizes(low, high, steps_per_decade))
+            sizes.push_back(size);
+    }
+    return !sizes.empty();
+}
+
+inline void print_usage(const char* program)
+{
+    printf("Usage: %s [options]\n"
+           "  --list                 list registered benchmarks and exit\n"
+           "  --filter=NAME[,NAME]   run benchmarks whose name contains any NAME (default: the standard set)\n"
+           "  --policy=P[,P]         run only these policies: seq, unseq, par, par_unseq, auto (default: all)\n"
+           "  --size=N[,N|LOW..HIGH] array sizes, e.g. 1e6, 100M, 1e6..1e9 for every decade (default: 100000000)\n"
+           "  --sweep[=MIN..MAX]     run over log-spaced working sets from MIN to MAX bytes (default: L1 size..4G)\n"
+           "  --steps-per-decade=N   sizes per decade of --size ranges (default: 1) and sweeps (default: 4)\n"
+           "  --threads=N[,N]|sweep  thread counts of parallel policies. sweep is 1, 2, 4 ... hardware threads (default: all)\n"
+           "  --page-in=MODE[,MODE]  page-in of benchmark buffers: none, serial or parallel first touch (default: serial)\n"
+           "  --pages=KIND[,KIND]    pages backing benchmark buffers: default, 4k, thp, 2m or 1g (Linux, default: default)\n"
+           "  --numa=POLICY[,POLICY] NUMA policy of benchmark buffers: none, local, interleave or firsttouch (Linux, default: none)\n"
+           "  --pin=MODE             pin threads to CPUs: none, compact (node by node) or spread (across nodes) (Linux, default: none)\n"
+           "  --resident[=LEVEL]     repeat each policy on buffers fitting in half of cache LEVEL: L1, L2 or L3 (default: L2),\n"
+           "                         reporting the first run against the steady state. 100 repetitions unless --reps is given\n"
+           "  --cache=STATE[,STATE]  caches before every repetition: warm, flush (the buffers, with clflushopt) or evict\n"
+           "                         (read a buffer twice the last level cache size), outside of the timed region (default: warm)\n"
+           "  --cold                 same as --cache=evict\n"
+           "  --match=POS[,POS]      first match of the search benchmarks at POS percent of the array, or none (default: none)\n"
+           "  --dist=DIST[,DIST]     inputs of the sort and merge benchmarks: uniform, sorted, reverse, nearly_sorted[:PERCENT],\n"
+           "                         few_unique[:VALUES], zipf[:EXPONENT], sawtooth[:TEETH], organ_pipe or equal (default: uniform)\n"
+           "  --merge-ratio=L:R[,L:R] proportion of the left and right input sizes of the merge benchmarks (default: 1:1)\n"
+           "  --bandwidth            measure attainable bandwidth with STREAM-style baselines first, and report results relative to it\n"
+           "  --counters             read hardware performance counters (Linux perf_event_open) around each timed region\n"
+           "  --json=FILE            write every sample, statistics and an environment manifest to FILE as JSON\n"
+           "  --csv=FILE             write the same as CSV, with the manifest in leading # comment lines\n"
+           "  --compare=BASE,CURRENT compare two --json or --csv results files instead of running, exit with 1 on regression\n"
+           "  --threshold=PERCENT    change of the median that --compare reports as a regression or improvement (default: 5)\n"
+           "  --alpha=P              significance level of the Mann-Whitney U test of --compare (default: 0.05)\n"
+           "  --reps=N               repetitions of each policy (default: 5)\n"
+           "  --warmup=N             unrecorded warm-up repetitions before the measured ones (default: 0)\n"
+           "  --ci=PERCENT           add repetitions until the 95%% confidence interval of the mean is within +-PERCENT\n"
+           "  --max-reps=N           limit of repetitions when --ci is given (default: 100)\n"
+           "  --quiet                print only the statistics of each policy, not every sample\n"
+           "  --help                 show this message\n", program);
+}
+
+inline bool parse_command_line(int argc, char* argv[])
+{
+    std::string sizes;
+    bool        reps_given = false;
+    for (int i = 0; i < argc; i++)
+        benchmark_options.command_line += std::string(i > 0 ? " " : "") + argv[i];
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg   = argv[i];
+        size_t      equal = arg.find('=');
+        std::string name  = arg.substr(0, equal);
+        std::string value = equal == std::string::npos ? std::string() : arg.substr(equal + 1);
+        double      count;
+
+        if (name == "--help" || name == "-h")
+        {
+            print_usage(argv[0]);
+            exit(0);
+        }
+        else if (name == "--list")
+            benchmark_options.list_only = true;
+        else if (name == "--filter" && !value.empty())
+            benchmark_options.filters = split_list(value);
+        else if (name == "--policy" && !value.empty())
+        {
+            benchmark_options.policies = split_list(value);
+            for (auto& p : benchmark_options.policies)
+            {
+                if (p != "seq" && p != "unseq" && p != "par" && p != "par_unseq" && p != "auto")
+                {
+                    fprintf(stderr, "Unknown policy: %s\n", p.c_str());
+                    return false;
+                }
+            }
+        }
+        else if (name == "--size" && !value.empty())
+            sizes = value;
+        else if (name == "--sweep" && value.empty())
+            benchmark_options.sweep = true;
+        else if (name == "--sweep" && value.find("..") != std::string::npos)
+        {
+            double low, high;
+            size_t range = value.find("..");
+            if (!parse_count(value.substr(0, range), low, 1024.0) || !parse_count(value.substr(range + 2), high, 1024.0) || low < 1.0 || high < low)
+            {
+                fprintf(stderr, "Invalid sweep range: %s\n", value.c_str());
+                return false;
+            }
+            benchmark_options.sweep     = true;
+            benchmark_options.sweep_min = (size_t)low;
+            benchmark_options.sweep_max = (size_t)high;
+        }
+        else if (name == "--threads" && value == "sweep")
+        {
+            benchmark_options.threads.clear();
+            for (size_t threads = 1; threads < hardware_threads(); threads *= 2)
+                benchmark_options.threads.push_back(threads);
+            benchmark_options.threads.push_back(hardware_threads());
+        }
+        else if (name == "--threads" && !value.empty())
+        {
+            benchmark_options.threads.clear();
+            for (auto& item : split_list(value))
+            {
+                if (!parse_count(item, count) || count < 1.0)
+                {
+                    fprintf(stderr, "Invalid thread count: %s\n", item.c_str());
+                    return false;
+                }
+                benchmark_options.threads.push_back((size_t)count);
+            }
+        }
+        else if (name == "--page-in" && !value.empty())
+        {
+            benchmark_options.page_in.clear();
+            for (auto& item : split_list(value))
+            {
+                PageIn page_in;
+                if (!parse_page_in(item, page_in))
+                {
+                    fprintf(stderr, "Unknown page-in mode: %s\n", item.c_str());
+                    return false;
+                }
+                benchmark_options.page_in.push_back(page_in);
+            }
+        }
+        else if (name == "--pages" && !value.empty())
+        {
+            benchmark_options.pages.clear();
+            for (auto& item : split_list(value))
+            {
+                PageKind pages;
+                if (!parse_page_kind(item, pages))
+                {
+                    fprintf(stderr, "Unknown kind of pages: %s\n", item.c_str());
+                    return false;
+                }
+                benchmark_options.pages.push_back(pages);
+            }
+        }
+        else if (name == "--numa" && !value.empty())
+        {
+            benchmark_options.numa.clear();
+            for (auto& item : split_list(value))
+            {
+                NumaPolicy numa;
+                if (!parse_numa_policy(item, numa))
+                {
+                    fprintf(stderr, "Unknown NUMA policy: %s\n", item.c_str());
+                    return false;
+                }
+                benchmark_options.numa.push_back(numa);
+            }
+        }
+        else if (name == "--pin" && (value.empty() || parse_pin_mode(value, benchmark_options.pin)))
+        {
+            if (value.empty())
+                benchmark_options.pin = PIN_COMPACT;
+        }
+        else if (name == "--steps-per-decade" && parse_count(value, count) && count >= 1.0)
+            benchmark_options.steps_per_decade = (size_t)count;
+        else if (name == "--reps" && parse_count(value, count) && count >= 1.0)
+        {
+            benchmark_options.num_times = (size_t)count;
+            reps_given = true;
+        }
+        else if (name == "--warmup" && parse_count(value, count))
+            benchmark_options.warmup = (size_t)count;
+        else if (name == "--ci" && parse_count(value, count) && count > 0.0)
+            benchmark_options.ci_target = count / 100.0;
+        else if (name == "--max-reps" && parse_count(value, count) && count >= 1.0)
+            benchmark_options.max_reps = (size_t)count;
+        else if (name == "--quiet")
+            benchmark_options.quiet = true;
+        else if (name == "--resident" && value.empty())
+            benchmark_options.resident_level = 2;
+        else if (name == "--resident" && value.size() == 2 && (value[0] == 'L' || value[0] == 'l') && value[1] >= '1' && value[1] <= '3')
+            benchmark_options.resident_level = value[1] - '0';
+        else if (name == "--cache" && !value.empty())
+        {
+            benchmark_options.cache.clear();
+            for (auto& item : split_list(value))
+            {
+                CacheState cache;
+                if (!parse_cache_state(item, cache))
+                {
+                    fprintf(stderr, "Unknown cache state: %s\n", item.c_str());
+                    return false;
+                }
+                benchmark_options.cache.push_back(cache);
+            }
+        }
+        else if (name == "--cold")
+            benchmark_options.cache = { CACHE_EVICT };
+        else if (name == "--match" && !value.empty())
+        {
+            benchmark_options.match.clear();
+            for (auto& item : split_list(value))
+            {
+                double match;
+                if (!parse_match(item, match))
+                {
+                    fprintf(stderr, "Invalid match position: %s\n", item.c_str());
+                    return false;
+                }
+                benchmark_options.match.push_back(match);
+            }
+        }
+        else if (name == "--dist" && !value.empty())
+        {
+            benchmark_options.distributions.clear();
+            for (auto& item : split_list(value))
+            {
+                InputDistribution distribution;
+                if (!parse_distribution(item, distribution))
+                {
+                    fprintf(stderr, "Unknown input distribution: %s\n", item.c_str());
+                    return false;
+                }
+                benchmark_options.distributions.push_back(distribution);
+            }
+        }
+        else if (name == "--merge-ratio" && !value.empty())
+        {
+            benchmark_options.merge_ratios.clear();
+            for (auto& item : split_list(value))
+            {
+                MergeRatio ratio;
+                if (!parse_merge_ratio(item, ratio))
+                {
+                    fprintf(stderr, "Invalid merge ratio: %s\n", item.c_str());
+                    return false;
+                }
+                benchmark_options.merge_ratios.push_back(ratio);
+            }
+        }
+        else if (name == "--bandwidth")
+            benchmark_options.bandwidth = true;
+        else if (name == "--counters")
+            benchmark_options.counters = true;
+        else if (name == "--json" && !value.empty())
+            benchmark_options.json_path = value;
+        else if (name == "--csv" && !value.empty())
+            benchmark_options.csv_path = value;
+        else if (name == "--compare" && !value.empty())
+        {
+            std::vector<std::string> paths = split_list(value);
+            if (paths.size() != 2)
+            {
+                fprintf(stderr, "--compare needs two results files: %s\n", value.c_str());
+                return false;
+            }
+            benchmark_options.compare_baseline = paths[0];
+            benchmark_options.compare_current  = paths[1];
+        }
+        else if (name == "--threshold" && parse_count(value, count))
+            benchmark_options.compare_threshold = count / 100.0;
+        else if (name == "--alpha" && parse_count(value, count) && count > 0.0 && count < 1.0)
+            benchmark_options.compare_alpha = count;
+        else
+        {
+            fprintf(stderr, "Invalid argument: %s\n", arg.c_str());
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    size_t steps = benchmark_options.steps_per_decade > 0 ? benchmark_options.steps_per_decade : 1;
+    if (!sizes.empty() && !parse_sizes(sizes, benchmark_options.sizes, steps))
+    {
+        fprintf(stderr, "Invalid size: %s\n", sizes.c_str());
+        return false;
+    }
+    if (benchmark_options.resident_level > 0)
+    {
+        if (sizes.empty())
+            benchmark_options.sizes.clear();
+        if (!reps_given)
+            benchmark_options.num_times = 100;
+        if (benchmark_options.warmup > 0)
+            fprintf(stderr, "--warmup is ignored in resident mode, which reports the first run\n");
+        benchmark_options.warmup = 0;
+    }
+    return true;
+}
+
+// Array sizes of a sweep over working sets of the benchmark
+inline std::vector<size_t> sweep_sizes(const BenchmarkEntry& entry)
+{
+    size_t steps = benchmark_options.steps_per_decade > 0 ? benchmark_options.steps_per_decade : 4;
+    double low   = (double)(benchmark_options.sweep_min > 0 ? benchmark_options.sweep_min : (cache_size(1) > 0 ? cache_size(1) : 32 * 1024));
+    double high  = (double)benchmark_options.sweep_max;
+    size_t bytes = entry.bytes_per_element > 0 ? entry.bytes_per_element : 1;
+    return log_spaced_sizes(std::max(low / (double)bytes, 1.0), std::max(high / (double)bytes, 1.0), steps);
+}
+
+// Array size of resident mode: the working set of the benchmark fills half of the cache level, leaving room for the
+// stack, the code and the data of the parallel backend
+inline std::vector<size_t> resident_sizes(const BenchmarkEntry& entry)
+{
+    static const size_t typical[] = { 0, 32 * 1024, 1024 * 1024, 32 * 1024 * 1024 };   // when the cache sizes are unknown
+    size_t cache = cache_size(benchmark_options.resident_level);
+    if (cache == 0)
+        cache = typical[benchmark_options.resident_level];
+    size_t bytes = entry.bytes_per_element > 0 ? entry.bytes_per_element : 1;
+    return { std::max(cache / 2 / bytes, (size_t)1) };
+}
+
+// Algorithm of a result tag, without its policy: "Parallel SIMD std::sort" is "std::sort"
+inline std::string algorithm_of(const std::string& tag)
+{
+    for (const char* prefix : { "Parallel SIMD ", "Parallel ", "Serial SIMD ", "Serial ", "SIMD ", "Adaptive " })
+        if (tag.compare(0, strlen(prefix), prefix) == 0)
+            return tag.substr(strlen(prefix));
+    return tag;
+}
+
+// For each algorithm measured at several sizes, prints the median time of its fastest serial (seq or unseq) and
+// fastest parallel (par or par_unseq) policy at each size, and the crossover size from which parallel stays faster
+inline void print_crossover(const char* benchmark, size_t first_result)
+{
+    std::vector<std::string> algorithms;
+    for (size_t r = first_result; r < benchmark_results.size(); r++)
+    {
+        std::string algorithm = algorithm_of(benchmark_results[r].tag);
+        if (std::find(algorithms.begin(), algorithms.end(), algorithm) == algorithms.end())
+            algorithms.push_back(algorithm);
+    }
+
+    size_t max_threads = 0;
+    for (size_t r = first_result; r < benchmark_results.size(); r++)
+        max_threads = std::max(max_threads, benchmark_results[r].threads);
+
+    printf("\nCrossover of %s: fastest parallel versus fastest serial policy (median times)\n", benchmark);
+    for (auto& algorithm : algorithms)
+    {
+        struct Point { size_t size; size_t working_set; std::string level; double serial; double parallel; };
+        std::vector<Point> points;
+        for (size_t r = first_result; r < benchmark_results.size(); r++)
+        {
+            const BenchmarkResult& result = benchmark_results[r];
+            if (algorithm_of(result.tag) != algorithm || result.stats.count == 0 || result.policy == "auto")
+                continue;
+            if (is_parallel(result.policy) && result.threads != max_threads)
+                continue;
+            auto point = std::find_if(points.begin(), points.end(), [&](const Point& p) { return p.size == result.array_size; });
+            if (point == points.end())
+                point = points.insert(points.end(), { result.array_size, result.working_set, result.cache_level, 0.0, 0.0 });
+            double& best = is_parallel(result.policy) ? point->parallel : point->serial;
+            if (best == 0.0 || result.stats.median < best)
+                best = result.stats.median;
+        }
+        points.erase(std::remove_if(points.begin(), points.end(), [](const Point& p) { return p.serial == 0.0 || p.parallel == 0.0; }), points.end());
+        if (points.size() < 2)
+            continue;
+        std::sort(points.begin(), points.end(), [](const Point& a, const Point& b) { return a.size < b.size; });
+
+        printf("%s:\n", algorithm.c_str());
+        size_t crossover = points.size();
+        for (size_t p = points.size(); p > 0 && points[p - 1].parallel < points[p - 1].serial; p--)
+            crossover = p - 1;
+        for (size_t p = 0; p < points.size(); p++)
+            printf("  size = %12zu  working set = %9s  %-7s  serial: %12fms  parallel: %12fms  speedup: %6.2f%s\n", points[p].size,
+                format_bytes((double)points[p].working_set).c_str(), points[p].level.c_str(), points[p].serial, points[p].parallel,
+                points[p].serial / points[p].parallel, p == crossover ? "  <= crossover" : "");
+        if (crossover < points.size())
+            printf("  parallel beats serial from size %zu (%s, %s) upward\n", points[crossover].size,
+                format_bytes((double)points[crossover].working_set).c_str(), points[crossover].level.c_str());
+        else
+            printf("  parallel does not stay ahead of serial at the largest sizes measured\n");
+    }
+}
+
+// Prints the speedup and parallel efficiency of each parallel policy at each thread count, relative to its median time
+// at the smallest thread count measured
+inline void print_thread_scaling(const char* benchmark, size_t first_result)
+{
+    printf("\nThread scaling of %s: speedup and efficiency versus the smallest thread count (median times)\n", benchmark);
+    for (size_t r = first_result; r < benchmark_results.size(); r++)
+    {
+        const BenchmarkResult& base = benchmark_results[r];
+        if (!is_parallel(base.policy) || base.stats.count == 0)
+            continue;
+        bool first = true;      // the same tag and size at a smaller thread count was printed already
+        for (size_t b = first_result; b < r && first; b++)
+            if (benchmark_results[b].tag == base.tag && benchmark_results[b].array_size == base.array_size)
+                first = false;
+        if (!first)
+            continue;
+
+        printf("%s: size = %zu\n", base.tag.c_str(), base.array_size);
+        for (size_t t = r; t < benchmark_results.size(); t++)
+        {
+            const BenchmarkResult& result = benchmark_results[t];
+            if (result.tag != base.tag || result.array_size != base.array_size || result.stats.count == 0)
+                continue;
+            double speedup    = base.stats.median / result.stats.median;
+            double efficiency = speedup * (double)base.threads / (double)result.threads;
+            printf("  threads = %4zu  median: %12fms  speedup: %6.2f  efficiency: %6.1f%%\n", result.threads, result.stats.median, speedup, 100.0 * efficiency);
+        }
+    }
+}
+
+// For each result of adaptive::auto_policy, prints its median time against the fastest fixed policy of the same
+// algorithm, size and thread count, flagging sizes where it lost more than 5%
+inline void print_adaptive(const char* benchmark, size_t first_result)
+{
+    bool header = false;
+    for (size_t r = first_result; r < benchmark_results.size(); r++)
+    {
+        const BenchmarkResult& adaptive = benchmark_results[r];
+        if (adaptive.policy != "auto" || adaptive.stats.count == 0)
+            continue;
+        const BenchmarkResult* best = nullptr;
+        for (size_t f = first_result; f < benchmark_results.size(); f++)
+        {
+            const BenchmarkResult& fixed = benchmark_results[f];
+            if (fixed.policy == "auto" || fixed.stats.count == 0 || fixed.array_size != adaptive.array_size ||
+                algorithm_of(fixed.tag) != algorithm_of(adaptive.tag) || (is_parallel(fixed.policy) && fixed.threads != adaptive.threads))
+                continue;
+            if (best == nullptr || fixed.stats.median < best->stats.median)
+                best = &fixed;
+        }
+        if (best == nullptr)
+            continue;
+        if (!header)
+            printf("\nAdaptive policy of %s versus the fastest fixed policy (median times)\n", benchmark);
+        header = true;
+        double loss = 100.0 * (adaptive.stats.median / best->stats.median - 1.0);
+        printf("%s: size = %12zu  threads = %4zu  adaptive: %12fms  fastest: %12fms (%s)  %+6.1f%%%s\n", algorithm_of(adaptive.tag).c_str(),
+            adaptive.array_size, adaptive.threads, adaptive.stats.median, best->stats.median, best->policy.c_str(), loss, loss > 5.0 ? "  <= slower" : "");
+    }
+}
+
+// For each result of resident mode, prints its first run against the steady state, the median of the last half of its
+// runs, and the run from which three consecutive runs are within 10% of the steady state. The first runs are listed
+// one by one, as they are where the cache effects show
+inline void print_convergence(const char* benchmark, size_t first_result)
+{
+    const double tolerance   = 0.10;
+    const size_t consecutive = 3;
+    const size_t listed      = 8;
+
+    printf("\nConvergence of %s: first run versus steady state (median of the last half of the runs)\n", benchmark);
+    for (size_t r = first_result; r < benchmark_results.size(); r++)
+    {
+        const BenchmarkResult&     result  = benchmark_results[r];
+        const std::vector<double>& samples = result.samples;
+        if (samples.size() < 2)
+            continue;
+        std::vector<double> last_half(samples.begin() + samples.size() / 2, samples.end());
+        std::sort(last_half.begin(), last_half.end());
+        double steady = percentile(last_half, 0.5);
+
+        size_t converged = samples.size();
+        for (size_t i = 0; i + consecutive <= samples.size() && converged == samples.size(); i++)
+        {
+            bool near = true;
+            for (size_t k = i; k < i + consecutive; k++)
+                near = near && std::fabs(samples[k] - steady) <= tolerance * steady;
+            if (near)
+                converged = i;
+        }
+
+        printf("%s: size = %zu  threads = %zu  first: %fms  steady: %fms  first/steady: %.2f  steady throughput: %.4g elements/s",
+            result.tag.c_str(), result.array_size, result.threads, samples.front(), steady, samples.front() / steady, (double)result.array_size / (steady * 1e-3));
+        if (result.bytes_moved > 0)
+            printf(" %.2f GB/s", bandwidth_of(result.bytes_moved, steady));
+        if (converged < samples.size())
+            printf("  converged at run %zu\n", converged + 1);
+        else
+            printf("  not converged\n");
+        printf("  runs:");
+        for (size_t i = 0; i < std::min(samples.size(), listed); i++)
+            printf(" %f", samples[i]);
+        printf("%sms\n", samples.size() > listed ? " ..." : "");
+    }
+}
+
+// For each search result, prints its median time at every --match position against its median time with no match,
+// when it scans the whole array. A policy that stops as soon as it finds the match takes about the fraction of the full
+// scan the match is at
+inline void print_early_exit(const char* benchmark, size_t first_result)
+{
+    printf("\nEarly exit of %s: median time by position of the first match, against the full scan (match = none)\n", benchmark);
+    for (size_t r = first_result; r < benchmark_results.size(); r++)
+    {
+        const BenchmarkResult& base = benchmark_results[r];
+        if (base.stats.count == 0)
+            continue;
+        auto same = [&](const BenchmarkResult& other)
+        {
+            return other.tag == base.tag && other.array_size == base.array_size && other.threads == base.threads &&
+                   other.distribution == base.distribution && other.merge_ratio == base.merge_ratio && other.stats.count > 0;
+        };
+        bool first = true;      // the same tag, size and thread count at another position was printed already
+        for (size_t b = first_result; b < r && first; b++)
+            if (same(benchmark_results[b]))
+                first = false;
+        if (!first)
+            continue;
+
+        const BenchmarkResult* full_scan = nullptr;
+        for (size_t f = r; f < benchmark_results.size(); f++)
+            if (same(benchmark_results[f]) && benchmark_results[f].match == "none")
+                full_scan = &benchmark_results[f];
+
+        printf("%s: size = %zu  threads = %zu\n", base.tag.c_str(), base.array_size, base.threads);
+        for (size_t m = r; m < benchmark_results.size(); m++)
+        {
+            const BenchmarkResult& result = benchmark_results[m];
+            if (!same(result))
+                continue;
+            printf("  match = %6s  median: %12fms", result.match.c_str(), result.stats.median);
+            if (full_scan != nullptr && full_scan->stats.median > 0.0)
+                printf("  of full scan: %6.1f%%", 100.0 * result.stats.median / full_scan->stats.median);
+            printf("\n");
+        }
+    }
+}
+
+// Ranks the algorithms by median time for each input distribution, size, thread count and merge ratio, with each one's
+// time relative to the fastest
+inline void print_distributions(const char* benchmark, size_t first_result)
+{
+    printf("\nInput distributions of %s: algorithms by median time, relative to the fastest\n", benchmark);
+    std::vector<bool> printed(benchmark_results.size(), false);
+    for (size_t r = first_result; r < benchmark_results.size(); r++)
+    {
+        const BenchmarkResult& base = benchmark_results[r];
+        if (printed[r] || base.stats.count == 0)
+            continue;
+        std::vector<const BenchmarkResult*> ranked;
+        for (size_t o = r; o < benchmark_results.size(); o++)
+        {
+            const BenchmarkResult& other = benchmark_results[o];
+            if (other.distribution == base.distribution && other.merge_ratio == base.merge_ratio && other.array_size == base.array_size &&
+                other.threads == base.threads && other.stats.count > 0)
+            {
+                ranked.push_back(&other);
+                printed[o] = true;
+            }
+        }
+        std::stable_sort(ranked.begin(), ranked.end(), [](const BenchmarkResult* a, const BenchmarkResult* b) { return a->stats.median < b->stats.median; });
+
+        printf("dist = %s%s%s  size = %zu  threads = %zu\n", base.distribution.c_str(), base.merge_ratio.empty() ? "" : "  merge ratio = ",
+            base.merge_ratio.c_str(), base.array_size, base.threads);
+        for (auto result : ranked)
+            printf("  %-50s  median: %12fms  %8.2fx\n", result->tag.c_str(), result->stats.median, result->stats.median / ranked.front()->stats.median);
+    }
+}
+
+// Runs the STREAM-style baselines at a size well beyond the last level cache, and sets the attainable bandwidth to
+// the best bandwidth any of them reached (from its fastest sample)
+inline void measure_attainable_bandwidth()
+{
+    printf("\n\nAttainable bandwidth baselines");
+    size_t first_result = benchmark_results.size();
+    for (auto& entry : benchmark_registry)
+    {
+        if (!is_bandwidth_baseline(entry))
+            continue;
+        size_t array_size  = std::max(4 * last_level_cache_size() / entry.bytes_per_element, (size_t)1 << 24);
+        current_benchmark  = &entry;
+        current_array_size = array_size;
+        current_threads    = hardware_threads();
+        current_first_threads = true;
+        printf("\n\nBaseline: %s  size = %zu  working set = %s", entry.name, array_size, format_bytes((double)(array_size * entry.bytes_per_element)).c_str());
+        entry.run(array_size, benchmark_options.num_times);
+    }
+    for (size_t r = first_result; r < benchmark_results.size(); r++)
+        attainable_bandwidth = std::max(attainable_bandwidth, bandwidth_of(benchmark_results[r].bytes_moved, benchmark_results[r].stats.min));
+    printf("\nAttainable bandwidth: %.2f GB/s\n", attainable_bandwidth);
+}
+
+// Every combination of the page-in modes, kinds of pages and NUMA policies selected for the benchmark buffers
+inline std::vector<BufferPlacement> buffer_placements()
+{
+    std::vector<BufferPlacement> placements;
+    for (NumaPolicy numa : benchmark_options.numa)
+        for (PageKind pages : benchmark_options.pages)
+            for (PageIn page_in : benchmark_options.page_in)
+                placements.push_back({ page_in, pages, numa });
+    return placements;
+}
+
+// Inputs of one run of a benchmark
+struct InputVariant
+{
+    InputDistribution distribution;
+    MergeRatio        merge_ratio;
+    double            match = -1.0;
+};
+
+// Every combination of the --dist, --merge-ratio and --match values the inputs of the benchmark vary by
+inline std::vector<InputVariant> input_variants(const BenchmarkEntry& entry)
+{
+    std::vector<InputDistribution> distributions = { InputDistribution() };
+    std::vector<MergeRatio>        merge_ratios  = { MergeRatio() };
+    std::vector<double>            matches       = { -1.0 };
+    if (entry.inputs & INPUTS_DISTRIBUTION)
+        distributions = benchmark_options.distributions;
+    if (entry.inputs & INPUTS_MERGE_RATIO)
+        merge_ratios = benchmark_options.merge_ratios;
+    if (entry.inputs & INPUTS_MATCH)
+        matches = benchmark_options.match;
+
+    std::vector<InputVariant> variants;
+    for (auto& distribution : distributions)
+        for (auto& merge_ratio : merge_ratios)
+            for (double match : matches)
+                variants.push_back({ distribution, merge_ratio, match });
+    return variants;
+}
+
+inline std::string input_description(const BenchmarkEntry& entry, const InputVariant& input)
+{
+    std::string description;
+    if (entry.inputs & INPUTS_DISTRIBUTION)
+        description += "  dist = " + distribution_name(input.distribution);
+    if (entry.inputs & INPUTS_MERGE_RATIO)
+        description += "  merge ratio = " + merge_ratio_name(input.merge_ratio);
+    if (entry.inputs & INPUTS_MATCH)
+        description += "  match = " + match_name(input.match);
+    return description;
+}
+
+inline int run_benchmarks()
+{
+    if (benchmark_options.list_only)
+    {
+        for (auto& entry : benchmark_registry)
+            printf("%s%s\n", entry.name, entry.run_by_default ? "" : "  (run only when selected by --filter)");
+        return 0;
+    }
+
+    std::vector<size_t> thread_counts = benchmark_options.threads;
+    if (thread_counts.empty())
+        thread_counts.push_back(hardware_threads());
+#ifndef BENCHMARK_THREAD_CONTROL
+    if (!benchmark_options.threads.empty())
+        fprintf(stderr, "Thread counts are not supported without TBB. Parallel policies use all hardware threads\n");
+#endif
+
+#ifdef BENCHMARK_THREAD_PINNING
+    ThreadPinning pinning(benchmark_options.pin);
+    if (benchmark_options.pin != PIN_NONE)
+        printf("Threads pinned %s over NUMA nodes %s\n", pin_mode_name(benchmark_options.pin), numa_topology().c_str());
+#else
+    if (benchmark_options.pin != PIN_NONE)
+        fprintf(stderr, "Thread pinning is supported only on Linux with TBB. Threads are not pinned\n");
+#endif
+
+    if (benchmark_options.counters)
+    {
+        perf_counters_open = perf_counters.open();
+        if (!perf_counters_open)
+            fprintf(stderr, "Hardware performance counters are not available%s%s. Continuing without them\n",
+                perf_counters.error().empty() ? "" : ": ", perf_counters.error().c_str());
+    }
+    if (benchmark_options.bandwidth)
+        measure_attainable_bandwidth();
+
+    size_t num_run = 0;
+    for (auto& entry : benchmark_registry)
+    {
+        if (!benchmark_selected(entry))
+            continue;
+        std::vector<size_t> sizes = benchmark_options.sweep ? sweep_sizes(entry) : benchmark_options.sizes.empty() ? resident_sizes(entry) : benchmark_options.sizes;
+        for (auto& placement : buffer_placements())
+        {
+            for (CacheState cache : benchmark_options.cache)
+            {
+                if (!entry.cache_control && cache != CACHE_WARM)
+                {
+                    fprintf(stderr, "%s sets up the caches itself and runs only with --cache=warm. Skipping cache = %s\n", entry.name, cache_state_name(cache));
+                    continue;
+                }
+                buffer_placement = placement;
+                current_cache    = cache;
+                size_t first_input_result = benchmark_results.size();
+                for (auto& input : input_variants(entry))
+                {
+                    current_distribution = input.distribution;
+                    current_merge_ratio  = input.merge_ratio;
+                    current_match        = input.match;
+                    size_t first_result  = benchmark_results.size();
+                    for (size_t array_size : sizes)
+                    {
+                        for (size_t t = 0; t < thread_counts.size(); t++)
+                        {
+#ifdef BENCHMARK_THREAD_CONTROL
+                            tbb::global_control thread_limit(tbb::global_control::max_allowed_parallelism, thread_counts[t]);
+#endif
+                            size_t working_set    = array_size * entry.bytes_per_element;
+                            current_benchmark     = &entry;
+                            current_array_size    = array_size;
+                            current_threads       = thread_counts[t];
+                            current_first_threads = t == 0;
+                            printf("\n\nBenchmark: %s  size = %zu  working set = %s (%s)  threads = %zu  %s  cache = %s%s  repetitions = %zu", entry.name, array_size,
+                                format_bytes((double)working_set).c_str(), cache_level_of(working_set).c_str(), thread_counts[t],
+                                placement_description(placement).c_str(), cache_state_name(cache), input_description(entry, input).c_str(),
+                                benchmark_options.num_times);
+                            reset_buffer_pages();
+                            entry.run(array_size, benchmark_options.num_times);
+                        }
+                    }
+                    if (sizes.size() > 1)
+                        print_crossover(entry.name, first_result);
+                    if (thread_counts.size() > 1)
+                        print_thread_scaling(entry.name, first_result);
+                    print_adaptive(entry.name, first_result);
+                    if (benchmark_options.resident_level > 0)
+                        print_convergence(entry.name, first_result);
+                }
+                if ((entry.inputs & INPUTS_MATCH) && benchmark_options.match.size() > 1)
+                    print_early_exit(entry.name, first_input_result);
+                if ((entry.inputs & INPUTS_DISTRIBUTION) && (benchmark_options.distributions.size() > 1 || benchmark_options.merge_ratios.size() > 1))
+                    print_distributions(entry.name, first_input_result);
+            }
+        }
+        num_run++;
+    }
+    if (num_run == 0)
+    {
+        fprintf(stderr, "No benchmarks match the filter. Use --list to see registered benchmarks\n");
+        return 1;
+    }
+    return 0;
+}
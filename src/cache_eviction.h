@@ -0,0 +1,129 @@
+// Cache state before a timed region, selected with --cache (each state is a separate run of the benchmark):
+//     warm   whatever the setup and the previous repetition (or policy) left in the caches (default)
+//     flush  every cache line of the live benchmark buffers is flushed to memory and invalidated in all caches, with
+//            clflushopt where the CPU has it and clflush otherwise. Other data, such as the stack, stays cached
+//     evict  a scratch buffer twice the size of the last level cache is read one cache line at a time, which replaces
+//            the lines of the benchmark buffers in the shared last level cache. The read is split into chunks run by the
+//            parallel policy's threads, so that the private caches of the cores those threads run on are replaced as
+//            well (on CPUs whose last level cache does not include them)
+// Both run in start_timer(), before the clock starts, so that policy-to-policy comparisons do not depend on the order
+// the policies run in. The scratch buffer is allocated on first use and kept, outside of the benchmark buffers.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark_allocator.h"
+#include "cpu_features.h"
+#include "parallel_utils.h"
+#include "system_info.h"
+
+enum CacheState
+{
+    CACHE_WARM,
+    CACHE_FLUSH,
+    CACHE_EVICT
+};
+
+inline const char* cache_state_name(CacheState cache)
+{
+    static const char* names[] = { "warm", "flush", "evict" };
+    return names[cache];
+}
+
+inline bool parse_cache_state(const std::string& name, CacheState& cache)
+{
+    for (int c = CACHE_WARM; c <= CACHE_EVICT; c++)
+    {
+        if (name == cache_state_name((CacheState)c))
+        {
+            cache = (CacheState)c;
+            return true;
+        }
+    }
+    return false;
+}
+
+const size_t eviction_line_bytes = 64;
+
+inline volatile size_t eviction_sink = 0;
+
+inline void evict_caches()
+{
+    static std::vector<unsigned char> scratch(2 * last_level_cache_size(), 1);
+
+    const size_t lines  = scratch.size() / eviction_line_bytes;
+    const size_t chunks = parallel_chunk_count(lines, 4096);
+    std::vector<size_t> sums(chunks);
+    parallel_for_chunks(chunks, [&](size_t c)
+    {
+        auto   bounds = chunk_bounds(lines, chunks, c);
+        size_t sum    = 0;
+        for (size_t l = bounds.first; l < bounds.second; l++)
+            sum += scratch[l * eviction_line_bytes];
+        sums[c] = sum;
+    });
+    size_t sum = 0;
+    for (size_t s : sums)
+        sum += s;
+    eviction_sink = sum;
+}
+
+BENCHMARK_TARGET("clflushopt")
+inline void flush_lines_clflushopt(const char* begin, const char* end)
+{
+    for (const char* line = begin; line < end; line += eviction_line_bytes)
+        _mm_clflushopt((void*)line);
+}
+
+inline void flush_lines_clflush(const char* begin, const char* end)
+{
+    for (const char* line = begin; line < end; line += eviction_line_bytes)
+        _mm_clflush(line);
+}
+
+// Flushes every live benchmark buffer from all caches, in parallel. The fence orders the flushes before the timed region
+inline void flush_buffers()
+{
+    std::vector<std::pair<const char*, const char*>> ranges;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex);
+        for (auto& buffer : buffer_mappings)
+        {
+            const char* begin = (const char*)((uintptr_t)buffer.first & ~(uintptr_t)(eviction_line_bytes - 1));
+            ranges.push_back({ begin, (const char*)buffer.first + buffer.second.bytes });
+        }
+    }
+    const bool optimized = cpu_features().clflushopt;
+    for (auto& range : ranges)
+    {
+        const size_t lines  = (size_t)(range.second - range.first + eviction_line_bytes - 1) / eviction_line_bytes;
+        const size_t chunks = parallel_chunk_count(lines, 4096);
+        parallel_for_chunks(chunks, [&](size_t c)
+        {
+            auto        bounds = chunk_bounds(lines, chunks, c);
+            const char* begin  = range.first + bounds.first  * eviction_line_bytes;
+            const char* end    = range.first + bounds.second * eviction_line_bytes;
+            if (optimized)
+                flush_lines_clflushopt(begin, end);
+            else
+                flush_lines_clflush(begin, end);
+            _mm_mfence();
+        });
+    }
+    _mm_mfence();
+}
+
+// Brings the caches to the given state before a timed region
+inline void prepare_caches(CacheState cache)
+{
+    if (cache == CACHE_FLUSH)
+        flush_buffers();
+    else if (cache == CACHE_EVICT)
+        evict_caches();
+}
@@ -0,0 +1,96 @@
+// Counter-based random numbers for the benchmark inputs. Number i of a seed is a function of the seed and i alone: the
+// output function of SplitMix64 applied to seed + (i + 1) * golden gamma, which is the i-th number of a SplitMix64
+// generator started from the seed. Any range of numbers can then be generated on its own, so buffers are filled in
+// parallel chunks, by vector kernels selected with CPUID, and hold the same numbers for a seed at any thread count.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "cpu_features.h"
+#include "parallel_utils.h"
+
+inline uint64_t random_at(uint64_t seed, uint64_t index)
+{
+    uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Number below bound (at most 2^32) from the upper 32 bits of a random number, by multiplication rather than division
+inline uint64_t random_below(uint64_t random, uint64_t bound)
+{
+    return ((random >> 32) * bound) >> 32;
+}
+
+// Number in [0, 1) from the upper 53 bits of a random number
+inline double random_unit(uint64_t random)
+{
+    return (double)(random >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Random number converted to T: floating point types from the upper 53 bits, which convert exactly and faster
+template <class T>
+inline T random_value(uint64_t random)
+{
+    if (std::is_floating_point<T>::value)
+        return static_cast<T>((int64_t)(random >> 11));
+    return static_cast<T>(random);
+}
+
+// data[i - begin] = number i of the seed for i in [begin, end), below bound unless bound is 0. The loops are the same in
+// each kernel, compiled for wider vectors, which the multiplications and shifts of random_at vectorize to. The 64-bit
+// multiplications need AVX-512DQ (vpmullq) to stay in 512-bit vectors, so the widest kernel needs it as well
+template <class T>
+void random_block_128(T* data, size_t begin, size_t end, uint64_t seed, uint64_t bound)
+{
+    if (bound == 0)
+        for (size_t i = begin; i < end; i++)
+            data[i - begin] = random_value<T>(random_at(seed, i));
+    else
+        for (size_t i = begin; i < end; i++)
+            data[i - begin] = random_value<T>(random_below(random_at(seed, i), bound));
+}
+
+template <class T>
+BENCHMARK_TARGET("avx2")
+void random_block_256(T* data, size_t begin, size_t end, uint64_t seed, uint64_t bound)
+{
+    if (bound == 0)
+        for (size_t i = begin; i < end; i++)
+            data[i - begin] = random_value<T>(random_at(seed, i));
+    else
+        for (size_t i = begin; i < end; i++)
+            data[i - begin] = random_value<T>(random_below(random_at(seed, i), bound));
+}
+
+template <class T>
+BENCHMARK_TARGET("avx512f,avx512dq")
+void random_block_512(T* data, size_t begin, size_t end, uint64_t seed, uint64_t bound)
+{
+    if (bound == 0)
+        for (size_t i = begin; i < end; i++)
+            data[i - begin] = random_value<T>(random_at(seed, i));
+    else
+        for (size_t i = begin; i < end; i++)
+            data[i - begin] = random_value<T>(random_below(random_at(seed, i), bound));
+}
+
+// Fills data with random numbers 0 .. n - 1 of the seed, below bound (at most 2^32) unless bound is 0, in parallel
+template <class T>
+void random_fill(T* data, size_t n, uint64_t seed, uint64_t bound = 0)
+{
+    const CpuFeatures& features = cpu_features();
+    const bool avx512 = features.avx512f && features.avx512dq;
+    void (*block)(T*, size_t, size_t, uint64_t, uint64_t) = avx512        ? random_block_512<T> :
+                                                            features.avx2 ? random_block_256<T> : random_block_128<T>;
+    const size_t chunks = parallel_chunk_count(n, (size_t)1 << 16);
+    parallel_for_chunks(chunks, [&](size_t c)
+    {
+        auto bounds = chunk_bounds(n, chunks, c);
+        block(data + bounds.first, bounds.first, bounds.second, seed, bound);
+    });
+}
@@ -0,0 +1,109 @@
+// Instruction set extensions of the CPU, detected at run time with CPUID, so that kernels compiled for several vector
+// widths pick the widest one the machine (and the operating system, which must save the wider registers) supports.
+// Kernels for extensions beyond the build flags are compiled with BENCHMARK_TARGET("avx2") and similar, which lets
+// g++ and clang emit those instructions in single functions. MSVC needs no attribute.
+#pragma once
+
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#if defined(__GNUC__)
+#define BENCHMARK_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BENCHMARK_TARGET(isa)
+#endif
+
+struct CpuFeatures
+{
+    bool sse2       = false;
+    bool sse42      = false;
+    bool avx        = false;
+    bool avx2       = false;
+    bool avx512f    = false;
+    bool avx512dq   = false;     // 64-bit integer multiplication (vpmullq) among others
+    bool clflushopt = false;     // cache line flush without the ordering of clflush
+};
+
+// EAX, EBX, ECX, EDX of CPUID leaf and subleaf
+inline void cpuid(unsigned leaf, unsigned subleaf, unsigned registers[4])
+{
+#if defined(_MSC_VER)
+    int values[4];
+    __cpuidex(values, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; i++)
+        registers[i] = (unsigned)values[i];
+#else
+    __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+// Register state the operating system saves on context switches (XCR0)
+inline unsigned long long xgetbv0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned low, high;
+    __asm__ volatile ("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return ((unsigned long long)high << 32) | low;
+#endif
+}
+
+inline const CpuFeatures& cpu_features()
+{
+    static const CpuFeatures features = []()
+    {
+        CpuFeatures found;
+        unsigned registers[4];
+        cpuid(0, 0, registers);
+        unsigned max_leaf = registers[0];
+        if (max_leaf < 1)
+            return found;
+
+        cpuid(1, 0, registers);
+        found.sse2  = (registers[3] >> 26) & 1;
+        found.sse42 = (registers[2] >> 20) & 1;
+        bool osxsave = (registers[2] >> 27) & 1;
+        bool avx     = (registers[2] >> 28) & 1;
+        unsigned long long xcr0 = osxsave ? xgetbv0() : 0;
+        bool ymm_saved = (xcr0 & 0x6) == 0x6;           // SSE and AVX state
+        bool zmm_saved = (xcr0 & 0xE6) == 0xE6;         // and opmask, upper ZMM0-15 and ZMM16-31 state
+        found.avx = avx && ymm_saved;
+
+        if (max_leaf >= 7)
+        {
+            cpuid(7, 0, registers);
+            found.avx2       = found.avx && ((registers[1] >> 5) & 1);
+            found.avx512f    = zmm_saved && ((registers[1] >> 16) & 1);
+            found.avx512dq   = zmm_saved && ((registers[1] >> 17) & 1);
+            found.clflushopt = (registers[1] >> 23) & 1;
+        }
+        return found;
+    }();
+    return features;
+}
+
+// Detected extensions, for example "sse2 avx avx2"
+inline std::string cpu_features_description()
+{
+    const CpuFeatures& features = cpu_features();
+    std::string description;
+    auto add = [&](bool present, const char* name)
+    {
+        if (present)
+            description += (description.empty() ? "" : " ") + std::string(name);
+    };
+    add(features.sse2,       "sse2");
+    add(features.sse42,      "sse4.2");
+    add(features.avx,        "avx");
+    add(features.avx2,       "avx2");
+    add(features.avx512f,    "avx512f");
+    add(features.avx512dq,   "avx512dq");
+    add(features.clflushopt, "clflushopt");
+    return description.empty() ? "none" : description;
+}
@@ -0,0 +1,88 @@
+// Parallel searches that stop early: all_of, any_of, equal and adjacent_find, which stop all workers once the answer is
+// known, and the placement of the first match of the search benchmarks selected with --match.
+//
+// The workers take blocks of early_exit_block elements in index order from a shared atomic counter, so the blocks
+// before a match are searched first whatever the thread count. A worker that finds a match lowers the shared index of
+// the first match found, and every worker checks that index before taking its next block, stopping once the block
+// would start after it. The work beyond a match is then at most one block per worker, where a static split into
+// chunks (as the standard parallel algorithms use) keeps the threads of the chunks before the match scanning to their
+// ends. adjacent_find needs the first match and not just any, which taking the blocks in order gives as well.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+#include "parallel_utils.h"
+
+const size_t early_exit_block = 8192;
+
+// Index of the first match of an array of n elements at fraction (0..1) of it, and n for no match (fraction < 0)
+inline size_t match_index(size_t n, double fraction)
+{
+    if (fraction < 0.0 || n == 0)
+        return n;
+    return std::min((size_t)(fraction * (double)n), n - 1);
+}
+
+// First index in [0, n) that search finds, or n. search(begin, end) returns the first match in [begin, end), or end
+template <class BlockSearch>
+size_t parallel_search_first(size_t n, BlockSearch search)
+{
+    std::atomic<size_t> next_block(0);
+    std::atomic<size_t> first(n);
+    const size_t workers = parallel_chunk_count(n, early_exit_block);
+    parallel_for_chunks(workers, [&](size_t)
+    {
+        for (;;)
+        {
+            size_t begin = next_block.fetch_add(early_exit_block, std::memory_order_relaxed);
+            if (begin >= n || begin >= first.load(std::memory_order_relaxed))
+                return;         // past the end, or past a match found by another worker
+            size_t end   = std::min(begin + early_exit_block, n);
+            size_t found = search(begin, end);
+            if (found < end)
+            {
+                size_t current = first.load(std::memory_order_relaxed);
+                while (found < current && !first.compare_exchange_weak(current, found, std::memory_order_relaxed))
+                    ;
+                return;         // the blocks left to this worker come after the match
+            }
+        }
+    });
+    return first.load();
+}
+
+template <class T, class Predicate>
+bool parallel_early_exit_any_of(const T* data, size_t n, Predicate predicate)
+{
+    return parallel_search_first(n, [&](size_t begin, size_t end) { return (size_t)(std::find_if(data + begin, data + end, predicate) - data); }) < n;
+}
+
+template <class T, class Predicate>
+bool parallel_early_exit_all_of(const T* data, size_t n, Predicate predicate)
+{
+    return parallel_search_first(n, [&](size_t begin, size_t end) { return (size_t)(std::find_if_not(data + begin, data + end, predicate) - data); }) == n;
+}
+
+template <class T>
+bool parallel_early_exit_equal(const T* a, const T* b, size_t n)
+{
+    return parallel_search_first(n, [&](size_t begin, size_t end) { return (size_t)(std::mismatch(a + begin, a + end, b + begin).first - a); }) == n;
+}
+
+// Index of the first element equal to the next one, or n
+template <class T>
+size_t parallel_early_exit_adjacent_find(const T* data, size_t n)
+{
+    if (n < 2)
+        return n;
+    size_t found = parallel_search_first(n - 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+            if (data[i] == data[i + 1])
+                return i;
+        return end;
+    });
+    return found < n - 1 ? found : n;
+}
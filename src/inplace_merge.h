@@ -0,0 +1,164 @@
+// Parallel in-place merge with a bounded workspace, for merges under a memory cap. std::inplace_merge allocates a
+// buffer as large as the shorter half and, when it cannot get one, falls back to an O(n log n) merge by rotations.
+//
+// The output is split into one segment per chunk. The merge path search of parallel_merge.h (co-ranking) finds which
+// elements of the left and right halves land in the first segments, and rotating the left elements of the later
+// segments past the right elements of the earlier ones brings the inputs of each side together. This is done by
+// halving: log2(chunks) levels, each moving every element at most once. While the parts of a level are fewer than the
+// threads, each part is rotated in parallel by three reversals; after that, the parts are rotated in parallel with
+// each other. Each segment is then merged by one thread, splitting and rotating the same way until either half of a
+// piece fits in the workspace, which that half is moved to and merged back from.
+// Ties are taken from the left half, so the merge is stable. Extra memory is one workspace of
+// inplace_merge_workspace_bytes per chunk.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "parallel_merge.h"
+#include "parallel_utils.h"
+
+const size_t inplace_merge_workspace_bytes = 64 * 1024;
+
+template <class T>
+void parallel_reverse(T* first, T* last)
+{
+    const size_t half   = (size_t)(last - first) / 2;
+    const size_t chunks = parallel_chunk_count(half, (size_t)1 << 16);
+    parallel_for_chunks(chunks, [&](size_t c)
+    {
+        auto bounds = chunk_bounds(half, chunks, c);
+        for (size_t i = bounds.first; i < bounds.second; i++)
+            std::swap(first[i], *(last - 1 - i));
+    });
+}
+
+// Rotates [first, last) so that middle becomes the first element, in parallel
+template <class T>
+void parallel_rotate(T* first, T* middle, T* last)
+{
+    if (first == middle || middle == last)
+        return;
+    parallel_reverse(first, middle);
+    parallel_reverse(middle, last);
+    parallel_reverse(first, last);
+}
+
+template <class T>
+struct InplaceMergePart
+{
+    T* first;
+    T* middle;
+    T* last;
+};
+
+// Rearranges the sorted halves of part so that the first `outputs` elements of their merge come first, each side
+// again as two sorted halves, which are returned
+template <class T, class Rotate>
+std::pair<InplaceMergePart<T>, InplaceMergePart<T>> inplace_merge_split(const InplaceMergePart<T>& part, size_t outputs, Rotate rotate)
+{
+    size_t from_left = merge_path_split(part.first, (size_t)(part.middle - part.first), part.middle, (size_t)(part.last - part.middle), outputs);
+    T*     later     = part.first + from_left;                  // left half elements of the later outputs
+    rotate(later, part.middle, part.middle + (outputs - from_left));
+    T*     split     = part.first + outputs;
+    return { { part.first, later, split }, { split, split + (part.middle - later), part.last } };
+}
+
+// Merges the sorted halves [first, middle) and [middle, last) on one thread, through a workspace of workspace_size
+template <class T>
+void inplace_merge_bounded(T* first, T* middle, T* last, T* workspace, size_t workspace_size)
+{
+    if (first == middle || middle == last || !(*middle < *(middle - 1)))
+        return;     // already in order
+
+    if ((size_t)(middle - first) <= workspace_size)            // forward, from the left half moved to the workspace
+    {
+        T* left     = workspace;
+        T* left_end = std::move(first, middle, workspace);
+        T* right    = middle;
+        T* out      = first;
+        while (left < left_end && right < last)
+            *out++ = *right < *left ? std::move(*right++) : std::move(*left++);
+        std::move(left, left_end, out);
+        return;
+    }
+    if ((size_t)(last - middle) <= workspace_size)             // backward, from the right half moved to the workspace
+    {
+        T* right     = std::move(middle, last, workspace);
+        T* left      = middle;
+        T* out       = last;
+        while (left > first && right > workspace)
+            *--out = *(right - 1) < *(left - 1) ? std::move(*--left) : std::move(*--right);
+        std::move_backward(workspace, right, out);
+        return;
+    }
+
+    auto parts = inplace_merge_split(InplaceMergePart<T>{ first, middle, last }, (size_t)(last - first) / 2,
+                                     [](T* f, T* m, T* l) { std::rotate(f, m, l); });
+    inplace_merge_bounded(parts.first.first,  parts.first.middle,  parts.first.last,  workspace, workspace_size);
+    inplace_merge_bounded(parts.second.first, parts.second.middle, parts.second.last, workspace, workspace_size);
+}
+
+// Merges the sorted halves [first, middle) and [middle, last) in place, in parallel, like std::inplace_merge
+template <class T>
+void parallel_inplace_merge(T* first, T* middle, T* last)
+{
+    const size_t n              = (size_t)(last - first);
+    const size_t workspace_size = std::max(inplace_merge_workspace_bytes / sizeof(T), (size_t)1);
+    const size_t chunks         = parallel_chunk_count(n, (size_t)1 << 16);
+    const size_t threads        = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // Split into one part per chunk, level by level. Each part knows how many chunks it is to be split into
+    std::vector<InplaceMergePart<T>> parts = { { first, middle, last } };
+    std::vector<size_t>              part_chunks = { chunks };
+    while (parts.size() < chunks)
+    {
+        std::vector<InplaceMergePart<T>> next(2 * parts.size());
+        std::vector<size_t>              next_chunks(2 * parts.size());
+        auto split = [&](size_t p, bool parallel)
+        {
+            if (part_chunks[p] == 1)
+            {
+                next[2 * p]            = parts[p];
+                next_chunks[2 * p]     = 1;
+                next_chunks[2 * p + 1] = 0;
+                return;
+            }
+            size_t left_chunks = part_chunks[p] / 2;
+            size_t outputs     = (size_t)(parts[p].last - parts[p].first) / part_chunks[p] * left_chunks;
+            auto   halves      = parallel ? inplace_merge_split(parts[p], outputs, [](T* f, T* m, T* l) { parallel_rotate(f, m, l); })
+                                          : inplace_merge_split(parts[p], outputs, [](T* f, T* m, T* l) { std::rotate(f, m, l); });
+            next[2 * p]            = halves.first;
+            next[2 * p + 1]        = halves.second;
+            next_chunks[2 * p]     = left_chunks;
+            next_chunks[2 * p + 1] = part_chunks[p] - left_chunks;
+        };
+        if (parts.size() < threads)
+        {
+            for (size_t p = 0; p < parts.size(); p++)
+                split(p, true);
+        }
+        else
+            parallel_for_chunks(parts.size(), [&](size_t p) { split(p, false); });
+
+        // Parts of one chunk are carried over, with an empty other half
+        parts.clear();
+        part_chunks.clear();
+        for (size_t p = 0; p < next.size(); p++)
+        {
+            if (next_chunks[p] == 0)
+                continue;
+            parts.push_back(next[p]);
+            part_chunks.push_back(next_chunks[p]);
+        }
+    }
+
+    parallel_for_chunks(parts.size(), [&](size_t p)
+    {
+        std::vector<T> workspace(workspace_size);
+        inplace_merge_bounded(parts[p].first, parts[p].middle, parts[p].last, workspace.data(), workspace_size);
+    });
+}
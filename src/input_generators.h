@@ -0,0 +1,228 @@
+// Input distributions of the sort and merge benchmarks, selected with --dist, and the size ratios of the two inputs of
+// the merge benchmarks, selected with --merge-ratio. Each is a separate run of those benchmarks.
+//
+//     uniform           uniformly random values over the whole range of integer types, and over the integers in
+//                       [0, 2^53) for float and double, which convert exactly (default)
+//     sorted            ascending
+//     reverse           descending
+//     nearly_sorted:K   ascending, with K% of the elements (default 1) swapped with elements at random positions
+//     few_unique:U      uniformly random among U distinct values (default 16)
+//     zipf:S            Zipf distributed with exponent S (default 1): the value of rank r is drawn with weight 1/r^S,
+//                       over as many ranks as elements, up to zipf_ranks
+//     sawtooth:T        T ascending runs (default 16)
+//     organ_pipe        ascending to the middle, then descending
+//     equal             every element equal
+//
+// A merge ratio L:R splits the elements of both merge inputs between the left and the right input in that proportion.
+// The generators are deterministic for a seed: benchmarks that pass every policy the same seed, or the same sequence of
+// seeds over the repetitions, give every policy the same inputs. They fill the inputs in parallel, except for the
+// swaps of nearly_sorted, which run serially since swaps at random positions may touch the same elements.
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "counter_random.h"
+#include "parallel_utils.h"
+
+enum DistributionKind
+{
+    DIST_UNIFORM,
+    DIST_SORTED,
+    DIST_REVERSE,
+    DIST_NEARLY_SORTED,
+    DIST_FEW_UNIQUE,
+    DIST_ZIPF,
+    DIST_SAWTOOTH,
+    DIST_ORGAN_PIPE,
+    DIST_EQUAL
+};
+
+struct InputDistribution
+{
+    DistributionKind kind      = DIST_UNIFORM;
+    double           parameter = 0.0;       // percentage perturbed, unique values, Zipf exponent or teeth. 0 is the default
+};
+
+const size_t zipf_ranks = (size_t)1 << 20;
+
+inline const char* distribution_kind_name(DistributionKind kind)
+{
+    static const char* names[] = { "uniform", "sorted", "reverse", "nearly_sorted", "few_unique", "zipf", "sawtooth", "organ_pipe", "equal" };
+    return names[kind];
+}
+
+// Parameter of a distribution, its default when not given
+inline double distribution_parameter(const InputDistribution& distribution)
+{
+    static const double defaults[] = { 0.0, 0.0, 0.0, 1.0, 16.0, 1.0, 16.0, 0.0, 0.0 };
+    return distribution.parameter > 0.0 ? distribution.parameter : defaults[distribution.kind];
+}
+
+inline bool has_parameter(DistributionKind kind)
+{
+    return kind == DIST_NEARLY_SORTED || kind == DIST_FEW_UNIQUE || kind == DIST_ZIPF || kind == DIST_SAWTOOTH;
+}
+
+// Name of a distribution with its parameter, such as nearly_sorted:1 or uniform
+inline std::string distribution_name(const InputDistribution& distribution)
+{
+    std::string name = distribution_kind_name(distribution.kind);
+    if (has_parameter(distribution.kind))
+    {
+        char parameter[32];
+        snprintf(parameter, sizeof(parameter), ":%g", distribution_parameter(distribution));
+        name += parameter;
+    }
+    return name;
+}
+
+inline bool parse_distribution(const std::string& text, InputDistribution& distribution)
+{
+    size_t      colon = text.find(':');
+    std::string kind  = text.substr(0, colon);
+    for (int k = DIST_UNIFORM; k <= DIST_EQUAL; k++)
+    {
+        if (kind != distribution_kind_name((DistributionKind)k))
+            continue;
+        distribution.kind      = (DistributionKind)k;
+        distribution.parameter = 0.0;
+        if (colon == std::string::npos)
+            return true;
+        char*       end       = nullptr;
+        std::string parameter = text.substr(colon + 1);
+        distribution.parameter = strtod(parameter.c_str(), &end);
+        return has_parameter(distribution.kind) && !parameter.empty() && *end == '\0' && distribution.parameter > 0.0 &&
+               (distribution.kind != DIST_NEARLY_SORTED || distribution.parameter <= 100.0);
+    }
+    return false;
+}
+
+// data[i] = value(i) for i in [0, n), in parallel chunks
+template <class T, class Value>
+void parallel_generate(T* data, size_t n, Value value)
+{
+    const size_t chunks = parallel_chunk_count(n, (size_t)1 << 16);
+    parallel_for_chunks(chunks, [&](size_t c)
+    {
+        auto bounds = chunk_bounds(n, chunks, c);
+        for (size_t i = bounds.first; i < bounds.second; i++)
+            data[i] = value(i);
+    });
+}
+
+// Fills data with n elements of the distribution, in parallel but for the swaps of nearly_sorted. The random numbers
+// are those of counter_random.h, so the input for a seed does not depend on the thread count
+template <class T>
+void generate_input(T* data, size_t n, const InputDistribution& distribution, uint64_t seed)
+{
+    const double parameter = distribution_parameter(distribution);
+
+    switch (distribution.kind)
+    {
+    case DIST_UNIFORM:
+        random_fill(data, n, seed);
+        break;
+    case DIST_SORTED:
+        parallel_generate(data, n, [](size_t i) { return static_cast<T>(i); });
+        break;
+    case DIST_REVERSE:
+        parallel_generate(data, n, [n](size_t i) { return static_cast<T>(n - 1 - i); });
+        break;
+    case DIST_NEARLY_SORTED:
+    {
+        parallel_generate(data, n, [](size_t i) { return static_cast<T>(i); });
+        size_t swaps = n == 0 ? 0 : (size_t)((double)n * parameter / 100.0 / 2.0);     // each swap moves two elements
+        for (size_t s = 0; s < swaps; s++)
+            std::swap(data[random_at(seed, 2 * s) % n], data[random_at(seed, 2 * s + 1) % n]);
+        break;
+    }
+    case DIST_FEW_UNIQUE:
+        random_fill(data, n, seed, std::min(std::max((uint64_t)parameter, (uint64_t)1), (uint64_t)1 << 32));
+        break;
+    case DIST_ZIPF:
+    {
+        // Inverse of the cumulative distribution over the ranks, through a guide table of the first rank of each of
+        // as many equal parts of [0, sum) as ranks, from which a rank is on average found within two steps
+        std::vector<double> cumulative(std::max(std::min(n, zipf_ranks), (size_t)1));
+        double sum = 0.0;
+        for (size_t r = 0; r < cumulative.size(); r++)
+            cumulative[r] = sum += 1.0 / std::pow((double)(r + 1), parameter);
+        const size_t        parts = cumulative.size();
+        std::vector<size_t> guide(parts);
+        for (size_t g = 0, r = 0; g < parts; g++)
+        {
+            while (r + 1 < parts && cumulative[r] <= sum * (double)g / (double)parts)
+                r++;
+            guide[g] = r;
+        }
+        parallel_generate(data, n, [&](size_t i)
+        {
+            double u    = random_unit(random_at(seed, i));
+            size_t rank = guide[std::min((size_t)(u * (double)parts), parts - 1)];
+            while (rank + 1 < parts && cumulative[rank] <= u * sum)
+                rank++;
+            return static_cast<T>(rank);
+        });
+        break;
+    }
+    case DIST_SAWTOOTH:
+    {
+        size_t tooth = std::max((size_t)((double)n / parameter), (size_t)1);
+        parallel_generate(data, n, [tooth](size_t i) { return static_cast<T>(i % tooth); });
+        break;
+    }
+    case DIST_ORGAN_PIPE:
+        parallel_generate(data, n, [n](size_t i) { return static_cast<T>(i < n / 2 ? i : n - 1 - i); });
+        break;
+    case DIST_EQUAL:
+        parallel_generate(data, n, [](size_t) { return static_cast<T>(1); });
+        break;
+    }
+}
+
+// Proportion of the elements of the left and right merge inputs
+struct MergeRatio
+{
+    size_t left  = 1;
+    size_t right = 1;
+};
+
+inline std::string merge_ratio_name(const MergeRatio& ratio)
+{
+    return std::to_string(ratio.left) + ":" + std::to_string(ratio.right);
+}
+
+inline bool parse_merge_ratio(const std::string& text, MergeRatio& ratio)
+{
+    size_t colon = text.find(':');
+    if (colon == std::string::npos)
+        return false;
+    char* left_end  = nullptr;
+    char* right_end = nullptr;
+    std::string left  = text.substr(0, colon);
+    std::string right = text.substr(colon + 1);
+    long long   l     = strtoll(left.c_str(),  &left_end,  10);
+    long long   r     = strtoll(right.c_str(), &right_end, 10);
+    if (left.empty() || right.empty() || *left_end != '\0' || *right_end != '\0' || l < 1 || r < 1)
+        return false;
+    ratio.left  = (size_t)l;
+    ratio.right = (size_t)r;
+    return true;
+}
+
+// Sizes of the left and right merge inputs of total elements, each at least one element when total allows
+inline std::pair<size_t, size_t> merge_input_sizes(size_t total, const MergeRatio& ratio)
+{
+    size_t left = (size_t)std::llround((double)total * (double)ratio.left / (double)(ratio.left + ratio.right));
+    if (total >= 2)
+        left = std::min(std::max(left, (size_t)1), total - 1);
+    return { left, total - left };
+}
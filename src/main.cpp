@@ -9,7 +9,9 @@
 //       but also the rest of run times to show this clearly by showing run time for each time use. Show that for large arrays running once versus running again and again, the times stay the same.
 //       This complicates parallel algorithm usage for arrays that fit into the cache. It becomes not clear which algorithm is best to use: parallel or serial and when to use each.
 //       This belongs in a blog entry of its own!
-// TODO: Make sure to page-in the buffer, even for fill, before benchmarking. Didn't seem to make much difference on my laptop
+//       --resident measures this: one cache-sized array used again and again, reporting the first run against the steady state and
+//       the run where they converge. --cold evicts the caches before every run, for comparison.
+// Buffers are bench_vector, paged in before benchmarking as selected by --page-in (see benchmark_allocator.h). Serial page-in did not seem to make much difference on my laptop
 // Conclusion: Not all parallel algorithms are advantageous when arrays fit into cache, with serial algorithms outperforming the parallel on first few runs only for some.
 
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__)
@@ -29,67 +31,90 @@
 #include <chrono>
 #endif
 
+#include <cmath>
 #include <iomanip>
 #include <iostream>
-#include <random>
+#include <limits>
 
 #include <immintrin.h>
 
+#include "benchmark_harness.h"
+#include "results_output.h"
+#include "results_compare.h"
+#include "radix_sort.h"
+#include "sample_sort.h"
+#include "merge_sort.h"
+#include "inplace_merge.h"
+#include "parallel_merge.h"
+#include "streaming_stores.h"
+#include "adaptive_policy.h"
+#include "simd_reductions.h"
+#include "early_exit_search.h"
+#include "input_generators.h"
+
 using namespace std;
 using std::chrono::duration;
 using std::chrono::duration_cast;
 using std::chrono::high_resolution_clock;
 using std::milli;
 
-void print_results(const char* const tag, const vector<int>& in_array,
+void print_results(const char* const tag, const bench_vector<int>& in_array,
     high_resolution_clock::time_point startTime,
     high_resolution_clock::time_point endTime)
 {
-    printf("%s: size = %zu  Lowest: %d Highest: %d Time: %fms\n", tag, in_array.size(), in_array.front(), in_array.back(),
-        duration_cast<duration<double, milli>>(endTime - startTime).count());
+    double time_ms = duration_cast<duration<double, milli>>(endTime - startTime).count();
+    if (record_sample(tag, time_ms, "int"))
+        printf("%s: size = %zu  Lowest: %d Highest: %d Time: %fms\n", tag, in_array.size(), in_array.front(), in_array.back(), time_ms);
 }
 
-void print_results(const char* const tag, std::vector<int>::iterator result, const vector<int>& in_array,
+void print_results(const char* const tag, bench_vector<int>::iterator result, const bench_vector<int>& in_array,
     high_resolution_clock::time_point startTime,
     high_resolution_clock::time_point endTime)
 {
-    printf("%s: size = %zu  Result: %d  Lowest: %d  Highest: %d  Time: %fms\n", tag, in_array.size(), *result,
-        in_array.front(), in_array.back(), duration_cast<duration<double, milli>>(endTime - startTime).count());
+    double time_ms = duration_cast<duration<double, milli>>(endTime - startTime).count();
+    if (record_sample(tag, time_ms, "int"))
+        printf("%s: size = %zu  Result: %d  Lowest: %d  Highest: %d  Time: %fms\n", tag, in_array.size(), *result,
+            in_array.front(), in_array.back(), time_ms);
 }
 
-void print_results(const char* const tag, size_t result, const vector<int>& in_array,
+void print_results(const char* const tag, size_t result, const bench_vector<int>& in_array,
     high_resolution_clock::time_point startTime,
     high_resolution_clock::time_point endTime)
 {
-    printf("%s: size = %zu  Result: %zu  Lowest: %d  Highest: %d  Time: %fms\n", tag, in_array.size(), result,
-        in_array.front(), in_array.back(), duration_cast<duration<double, milli>>(endTime - startTime).count());
+    double time_ms = duration_cast<duration<double, milli>>(endTime - startTime).count();
+    if (record_sample(tag, time_ms, "int"))
+        printf("%s: size = %zu  Result: %zu  Lowest: %d  Highest: %d  Time: %fms\n", tag, in_array.size(), result,
+            in_array.front(), in_array.back(), time_ms);
 }
 
-void print_results(const char* const tag, const vector<long long>& in_array,
+void print_results(const char* const tag, const bench_vector<long long>& in_array,
     high_resolution_clock::time_point startTime,
     high_resolution_clock::time_point endTime)
 {
-    printf("%s: size = %zu  Lowest: %lld Highest: %lld Time: %fms\n", tag, in_array.size(), in_array.front(), in_array.back(),
-        duration_cast<duration<double, milli>>(endTime - startTime).count());
+    double time_ms = duration_cast<duration<double, milli>>(endTime - startTime).count();
+    if (record_sample(tag, time_ms, "long long"))
+        printf("%s: size = %zu  Lowest: %lld Highest: %lld Time: %fms\n", tag, in_array.size(), in_array.front(), in_array.back(), time_ms);
 }
 
-void print_results(const char* const tag, const vector<double>& in_array,
+void print_results(const char* const tag, const bench_vector<double>& in_array,
     high_resolution_clock::time_point startTime,
     high_resolution_clock::time_point endTime)
 {
-    printf("%s: size = %zu  %p  Lowest: %g Highest: %g Time: %fms\n", tag, in_array.size(), in_array.data(), in_array.front(), in_array.back(),
-        duration_cast<duration<double, milli>>(endTime - startTime).count());
+    double time_ms = duration_cast<duration<double, milli>>(endTime - startTime).count();
+    if (record_sample(tag, time_ms, "double"))
+        printf("%s: size = %zu  %p  Lowest: %g Highest: %g Time: %fms\n", tag, in_array.size(), in_array.data(), in_array.front(), in_array.back(), time_ms);
 }
 
-void print_results(const char* const tag, const vector<size_t>& in_array,
+void print_results(const char* const tag, const bench_vector<size_t>& in_array,
     high_resolution_clock::time_point startTime,
     high_resolution_clock::time_point endTime)
 {
-    printf("%s: size = %zu  %p  Lowest: %zu Highest: %zu Time: %fms\n", tag, in_array.size(), in_array.data(), in_array.front(), in_array.back(),
-        duration_cast<duration<double, milli>>(endTime - startTime).count());
+    double time_ms = duration_cast<duration<double, milli>>(endTime - startTime).count();
+    if (record_sample(tag, time_ms, "size_t"))
+        printf("%s: size = %zu  %p  Lowest: %zu Highest: %zu Time: %fms\n", tag, in_array.size(), in_array.data(), in_array.front(), in_array.back(), time_ms);
 }
 
-void fill_scalar_around_cache(vector<int>& data, int value)
+void fill_scalar_around_cache(bench_vector<int>& data, int value)
 {
     int* p_data = data.data();
 
@@ -99,7 +124,7 @@ void fill_scalar_around_cache(vector<int>& data, int value)
     }
 }
 
-void fill_scalar_around_cache_64(vector<int>& data, int value)
+void fill_scalar_around_cache_64(bench_vector<int>& data, int value)
 {
     long long* p_data = (long long *)data.data();
     size_t end = data.size() / 2;
@@ -122,176 +147,184 @@ void fill_scalar_around_cache(int* p_data, size_t l, size_t r, int value)
 void fill_benchmark(size_t array_size, size_t num_times)
 {
     high_resolution_clock::time_point startTime, endTime;
-    std::vector<int>       data(array_size);
+    bench_vector<int>       data(array_size);
 
     printf("\n\n");
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(std::execution::seq, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial std::fill", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("fill_scalar_around_cache", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         fill_scalar_around_cache(data, 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("fill_scalar_around_cache", data, startTime, endTime);
     }
 
-    //for (size_t i = 0; i < num_times; i++)
-    //{
-    //    startTime = high_resolution_clock::now();
-    //    //ParallelAlgorithms::parallel_fill(data.data(), 42, 0, data.size() - 1, data.size() / 8);
-    //    ParallelAlgorithms::parallel_fill(data.data(), 42, 0, data.size() - 1, data.size() / 8);
-    //    endTime = high_resolution_clock::now();
-    //    print_results("parallel_fill", data, startTime, endTime);
-    //}
+    // Streaming stores of the widest vectors the CPU supports, in parallel (streaming_stores.h)
+    for (size_t i = 0; next_iteration("Parallel non-temporal fill", i, num_times); i++)
+    {
+        startTime = start_timer();
+        parallel_fill_streaming(data.data(), data.size(), 42);
+        endTime = stop_timer();
+        print_results("Parallel non-temporal fill", data, startTime, endTime);
+    }
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(std::execution::unseq, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial SIMD std::fill", data, startTime, endTime);
     }
 #endif
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(std::execution::par, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel std::fill", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(std::execution::par_unseq, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::fill", data, startTime, endTime);
     }
 
 #ifdef DPL_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(oneapi::dpl::execution::seq, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::fill", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(oneapi::dpl::execution::unseq, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::fill", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(oneapi::dpl::execution::par, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::fill", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(oneapi::dpl::execution::par_unseq, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::fill", data, startTime, endTime);
     }
 
-//    for (size_t i = 0; i < num_times; i++)
+//    for (size_t i = 0; next_iteration("Parallel DPCPP_DEFAULT dpl::fill", i, num_times); i++)
 //    {
-//        startTime = high_resolution_clock::now();
+//        startTime = start_timer();
 //        std::fill(oneapi::dpl::execution::dpcpp_default, data.begin(), data.end(), 42);
-//        endTime = high_resolution_clock::now();
+//        endTime = stop_timer();
 //        print_results("Parallel DPCPP_DEFAULT dpl::fill", data, startTime, endTime);
 //    }
 #endif
 }
 
-void fill_long_long_benchmark(size_t array_size, int num_times)
+void fill_long_long_benchmark(size_t array_size, size_t num_times)
 {
     high_resolution_clock::time_point startTime, endTime;
-    std::vector<long long>       data(array_size);
+    bench_vector<long long>       data(array_size);
 
     printf("\n\n");
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(std::execution::seq, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial std::fill", data, startTime, endTime);
     }
 
-    //startTime = high_resolution_clock::now();
+    //startTime = start_timer();
     //std::fill(std::execution::unseq, data.begin(), data.end(), 42);
-    //endTime = high_resolution_clock::now();
+    //endTime = stop_timer();
     //print_results("SIMD Fill", data, startTime, endTime);
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(std::execution::par, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel std::fill", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(std::execution::par_unseq, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::fill", data, startTime, endTime);
     }
 
+    for (size_t i = 0; next_iteration("Parallel non-temporal fill", i, num_times); i++)
+    {
+        startTime = start_timer();
+        parallel_fill_streaming(data.data(), data.size(), 42LL);
+        endTime = stop_timer();
+        print_results("Parallel non-temporal fill", data, startTime, endTime);
+    }
+
 #ifdef DPL_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(oneapi::dpl::execution::seq, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::fill", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(oneapi::dpl::execution::unseq, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::fill", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(oneapi::dpl::execution::par, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::fill", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::fill", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         std::fill(oneapi::dpl::execution::par_unseq, data.begin(), data.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::fill", data, startTime, endTime);
     }
 
-//    for (size_t i = 0; i < num_times; i++)
+//    for (size_t i = 0; next_iteration("Parallel DPCPP_DEFAULT dpl::fill", i, num_times); i++)
 //    {
-//        startTime = high_resolution_clock::now();
+//        startTime = start_timer();
 //        std::fill(oneapi::dpl::execution::dpcpp_default, data.begin(), data.end(), 42);
-//        endTime = high_resolution_clock::now();
+//        endTime = stop_timer();
 //        print_results("Parallel DPCPP_DEFAULT dpl::fill", data, startTime, endTime);
 //    }
 #endif
@@ -302,143 +335,214 @@ void sort_benchmark(size_t array_size, size_t num_times)
     //std::cout << "Size of int: " << sizeof(int) << std::endl;
     printf("\n\n");
 
-    std::vector<int>       data(     array_size);
-    std::vector<int>       data_copy(array_size);
+    bench_vector<int>       data(     array_size);
+    bench_vector<int>       data_copy(array_size);
 
     high_resolution_clock::time_point startTime, endTime;
-    //random_device rd;
-    std::mt19937_64 dist(1234);
 
-    for (auto& d : data) {
-        //d = static_cast<int>(rd());
-        d = static_cast<int>(dist());   // way faster on Linux
-    }
+    generate_input(data.data(), array_size, current_distribution, 1234);     // of --dist, uniform by default
 
     // std::sort benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         sort(std::execution::seq, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial std::sort", data, startTime, endTime);
     }
 
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         sort(std::execution::unseq, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial SIMD std::sort", data, startTime, endTime);
     }
 #endif
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         sort(std::execution::par, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel std::sort", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         sort(std::execution::par_unseq, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::sort", data, startTime, endTime);
     }
 
+    // Parallel LSD radix sort (radix_sort.h), which allocates its scratch buffer on every call like std::sort does
+
+    bool radix_sorted = false;
+    for (size_t i = 0; next_iteration("Parallel radix sort", i, num_times); i++)
+    {
+        copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
+
+        startTime = start_timer();
+        parallel_radix_sort(data_copy.data(), data_copy.data() + data_copy.size());
+        endTime = stop_timer();
+        print_results("Parallel radix sort", data, startTime, endTime);
+        radix_sorted = true;
+    }
+    if (radix_sorted)
+    {
+        bench_vector<int> reference(data.begin(), data.end());
+        sort(std::execution::par, reference.begin(), reference.end());
+        if (!equal(std::execution::par, reference.begin(), reference.end(), data_copy.begin()))
+            printf("Parallel radix sort: result differs from std::sort!\n");
+    }
+
+    // In-place parallel samplesort (sample_sort.h), which needs a few blocks per bucket and thread instead of a copy of the array
+
+    bool sample_sorted = false;
+    for (size_t i = 0; next_iteration("Parallel sample sort", i, num_times); i++)
+    {
+        copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
+
+        startTime = start_timer();
+        parallel_sample_sort(data_copy.data(), data_copy.data() + data_copy.size());
+        endTime = stop_timer();
+        print_results("Parallel sample sort", data, startTime, endTime);
+        sample_sorted = true;
+    }
+    if (sample_sorted)
+    {
+        bench_vector<int> reference(data.begin(), data.end());
+        sort(std::execution::par, reference.begin(), reference.end());
+        if (!equal(std::execution::par, reference.begin(), reference.end(), data_copy.begin()))
+            printf("Parallel sample sort: result differs from std::sort!\n");
+    }
+
     // dpl::sort benchmarks
 
 #ifdef DPL_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         sort(oneapi::dpl::execution::seq, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::sort", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         sort(oneapi::dpl::execution::unseq, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::sort", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         sort(oneapi::dpl::execution::par, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::sort", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         sort(oneapi::dpl::execution::par_unseq, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::sort", data, startTime, endTime);
     }
 #endif
 }
 
-void sort_doubles_benchmark(size_t array_size, int num_times, bool reuse_array)
+// Whether result holds the elements of input in the order of std::sort with operator<, independently of RadixKey.
+// NaNs, which operator< does not order, are left out of the comparison but must keep their count, and equal
+// elements compare with ==, so -0.0 and +0.0 may come in either order
+template <class T>
+bool equals_std_sort(const bench_vector<T>& result, const bench_vector<T>& input)
+{
+    auto not_nan = [](T value) { return value == value; };
+    std::vector<T> reference(input.size()), ordered(result.size());
+    reference.resize((size_t)(copy_if(std::execution::par, input.begin(),  input.end(),  reference.begin(), not_nan) - reference.begin()));
+    ordered.resize(  (size_t)(copy_if(std::execution::par, result.begin(), result.end(), ordered.begin(),   not_nan) - ordered.begin()));
+    if (reference.size() != ordered.size() || !is_sorted(std::execution::par, ordered.begin(), ordered.end()))
+        return false;
+    sort(std::execution::par, reference.begin(), reference.end());
+    return equal(std::execution::par, reference.begin(), reference.end(), ordered.begin());
+}
+
+// Doubles of both signs with fractions, and among them -0.0, +0.0, infinities and NaNs of both signs, which the
+// distributions of --dist (nonnegative integers for floating point) do not produce
+inline void generate_mixed_sign_doubles(double* data, size_t n, uint64_t seed)
+{
+    parallel_generate(data, n, [seed](size_t i)
+    {
+        uint64_t random = random_at(seed, i);
+        switch (random & 1023)
+        {
+        case 0:  return -0.0;
+        case 1:  return 0.0;
+        case 2:  return  std::numeric_limits<double>::infinity();
+        case 3:  return -std::numeric_limits<double>::infinity();
+        case 4:  return  std::numeric_limits<double>::quiet_NaN();
+        case 5:  return -std::numeric_limits<double>::quiet_NaN();
+        default:
+        {
+            double value = std::ldexp(random_value<double>(random), -26);
+            return (random >> 10) & 1 ? -value : value;
+        }
+        }
+    });
+}
+
+void sort_doubles_benchmark(size_t array_size, size_t num_times, bool reuse_array)
 {
     //std::cout << "Size of int: " << sizeof(int) << std::endl;
     printf("\n\n");
 
-    vector<double> data(array_size);
+    bench_vector<double> data(array_size);
     high_resolution_clock::time_point startTime, endTime;
-    random_device rd;
+    const uint64_t seed = 1234;     // repetition i of every policy sorts the input of --dist for seed + i
 
-    for (auto& d : data) {
-        d = static_cast<double>(rd());
-    }
+    generate_input(data.data(), array_size, current_distribution, seed);
 
     // std::sort benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::sort<double>", i, num_times); i++)
     {
         if (reuse_array)
         {
-            for (auto& d : data) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            generate_input(data.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(std::execution::seq, data.begin(), data.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Serial std::sort<double>", data, startTime, endTime);
         }
         else
         {
-            vector<double> data_loc(array_size);
-            for (auto& d : data_loc) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            bench_vector<double> data_loc(array_size);
+            generate_input(data_loc.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(std::execution::seq, data_loc.begin(), data_loc.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Serial std::sort<double>", data_loc, startTime, endTime);
         }
     }
@@ -447,358 +551,475 @@ void sort_doubles_benchmark(size_t array_size, int num_times, bool reuse_array)
     //    d = static_cast<int>(rd());
     //}
 
-    //startTime = high_resolution_clock::now();
+    //startTime = start_timer();
     //sort(std::execution::unseq, data.begin(), data.end());
-    //endTime = high_resolution_clock::now();
+    //endTime = stop_timer();
     //print_results("SIMD std::sort", data, startTime, endTime);
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::sort<double>", i, num_times); i++)
     {
         if (reuse_array)
         {
-            for (auto& d : data) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            generate_input(data.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(std::execution::par, data.begin(), data.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Parallel std::sort<double>", data, startTime, endTime);
         }
         else
         {
-            vector<double> data_loc(array_size);
-            for (auto& d : data_loc) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            bench_vector<double> data_loc(array_size);
+            generate_input(data_loc.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(std::execution::par, data_loc.begin(), data_loc.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Parallel std::sort<double>", data_loc, startTime, endTime);
         }
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::sort<double>", i, num_times); i++)
     {
         if (reuse_array)
         {
-            for (auto& d : data) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            generate_input(data.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(std::execution::par_unseq, data.begin(), data.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Parallel SIMD std::sort<double>", data, startTime, endTime);
         }
         else
         {
-            vector<double> data_loc(array_size);
-            for (auto& d : data_loc) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            bench_vector<double> data_loc(array_size);
+            generate_input(data_loc.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(std::execution::par_unseq, data_loc.begin(), data_loc.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Parallel SIMD std::sort<double>", data_loc, startTime, endTime);
         }
     }
 
+    // Parallel LSD radix sort (radix_sort.h)
+
+    for (size_t i = 0; next_iteration("Parallel radix sort<double>", i, num_times); i++)
+    {
+        if (reuse_array)
+        {
+            generate_input(data.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
+            parallel_radix_sort(data.data(), data.data() + data.size());
+            endTime = stop_timer();
+            print_results("Parallel radix sort<double>", data, startTime, endTime);
+            if (i == 0)
+            {
+                bench_vector<double> input(array_size);
+                generate_input(input.data(), array_size, current_distribution, seed + i);
+                if (!equals_std_sort(data, input))
+                    printf("Parallel radix sort<double>: result differs from std::sort!\n");
+            }
+        }
+        else
+        {
+            bench_vector<double> data_loc(array_size);
+            generate_input(data_loc.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
+            parallel_radix_sort(data_loc.data(), data_loc.data() + data_loc.size());
+            endTime = stop_timer();
+            print_results("Parallel radix sort<double>", data_loc, startTime, endTime);
+            if (i == 0)
+            {
+                bench_vector<double> input(array_size);
+                generate_input(input.data(), array_size, current_distribution, seed + i);
+                if (!equals_std_sort(data_loc, input))
+                    printf("Parallel radix sort<double>: result differs from std::sort!\n");
+            }
+        }
+    }
+
+    // Mixed-sign input, for the negative, -0.0 and NaN keys of RadixKey
+
+    {
+        bench_vector<double> mixed(array_size);
+        bench_vector<double> mixed_sorted(array_size);
+        generate_mixed_sign_doubles(mixed.data(), array_size, 4321);
+        bool mixed_ran = false;
+        for (size_t i = 0; next_iteration("Parallel radix sort<double> mixed sign", i, num_times); i++)
+        {
+            copy(std::execution::par, mixed.begin(), mixed.end(), mixed_sorted.begin());
+
+            startTime = start_timer();
+            parallel_radix_sort(mixed_sorted.data(), mixed_sorted.data() + mixed_sorted.size());
+            endTime = stop_timer();
+            print_results("Parallel radix sort<double> mixed sign", mixed_sorted, startTime, endTime);
+            mixed_ran = true;
+        }
+        if (mixed_ran && !equals_std_sort(mixed_sorted, mixed))
+            printf("Parallel radix sort<double> mixed sign: result differs from std::sort!\n");
+    }
+
     // dpl::sort benchmarks
 
 #ifdef DPL_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::sort<double>", i, num_times); i++)
     {
         if (reuse_array)
         {
-            for (auto& d : data) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            generate_input(data.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(oneapi::dpl::execution::seq, data.begin(), data.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Serial dpl::sort<double>", data, startTime, endTime);
         }
         else
         {
-            vector<double> data_loc(array_size);
-            for (auto& d : data_loc) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            bench_vector<double> data_loc(array_size);
+            generate_input(data_loc.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(oneapi::dpl::execution::seq, data_loc.begin(), data_loc.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Serial dpl::sort<double>", data_loc, startTime, endTime);
         }
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD dpl::sort<double>", i, num_times); i++)
     {
         if (reuse_array)
         {
-            for (auto& d : data) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            generate_input(data.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(oneapi::dpl::execution::unseq, data.begin(), data.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Serial SIMD dpl::sort<double>", data, startTime, endTime);
         }
         else
         {
-            vector<double> data_loc(array_size);
-            for (auto& d : data_loc) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            bench_vector<double> data_loc(array_size);
+            generate_input(data_loc.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(oneapi::dpl::execution::unseq, data_loc.begin(), data_loc.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Serial SIMD dpl::sort<double>", data_loc, startTime, endTime);
         }
     }
 
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::sort<double>", i, num_times); i++)
     {
         if (reuse_array)
         {
-            for (auto& d : data) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            generate_input(data.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(oneapi::dpl::execution::par, data.begin(), data.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Parallel dpl::sort<double>", data, startTime, endTime);
         }
         else
         {
-            vector<double> data_loc(array_size);
-            for (auto& d : data_loc) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            bench_vector<double> data_loc(array_size);
+            generate_input(data_loc.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(oneapi::dpl::execution::par, data_loc.begin(), data_loc.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Parallel dpl::sort<double>", data_loc, startTime, endTime);
         }
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::sort<double>", i, num_times); i++)
     {
         if (reuse_array)
         {
-            for (auto& d : data) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            generate_input(data.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(oneapi::dpl::execution::par_unseq, data.begin(), data.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Parallel SIMD dpl::sort<double>", data, startTime, endTime);
         }
         else
         {
-            vector<double> data_loc(array_size);
-            for (auto& d : data_loc) {
-                d = static_cast<double>(rd());
-            }
-            startTime = high_resolution_clock::now();
+            bench_vector<double> data_loc(array_size);
+            generate_input(data_loc.data(), array_size, current_distribution, seed + i);
+            startTime = start_timer();
             sort(oneapi::dpl::execution::par_unseq, data_loc.begin(), data_loc.end());
-            endTime = high_resolution_clock::now();
+            endTime = stop_timer();
             print_results("Parallel SIMD dpl::sort<double>", data_loc, startTime, endTime);
         }
     }
 #endif
 }
 
+// Key with the position it came from, ordered by the key alone, to tell whether a sort keeps equal keys in order
+struct KeyIndex
+{
+    int    key;
+    size_t index;
+
+    bool operator<(const KeyIndex& other) const { return key < other.key; }
+};
+
+// Whether parallel_merge_sort orders pairs of the input values reduced to 1024 keys, so that most keys are repeated,
+// and their positions exactly as std::stable_sort does. Checks at most the first 2^24 values, to bound the memory
+inline bool merge_sort_is_stable(const bench_vector<int>& data)
+{
+    const size_t n = std::min(data.size(), (size_t)1 << 24);
+    std::vector<KeyIndex> pairs(n), reference(n);
+    for (size_t i = 0; i < n; i++)
+        pairs[i] = reference[i] = { data[i] & 1023, i };
+    parallel_merge_sort(pairs.data(), pairs.data() + n);
+    stable_sort(std::execution::par, reference.begin(), reference.end());
+    return equal(std::execution::par, pairs.begin(), pairs.end(), reference.begin(),
+                 [](const KeyIndex& a, const KeyIndex& b) { return a.key == b.key && a.index == b.index; });
+}
+
 void stable_sort_benchmark(size_t array_size, size_t num_times)
 {
-    vector<int> data(array_size);
-    vector<int> data_copy(array_size);
+    bench_vector<int> data(array_size);
+    bench_vector<int> data_copy(array_size);
     high_resolution_clock::time_point startTime, endTime;
-    //random_device rd;
-    std::mt19937_64 dist(1234);
 
-    for (auto& d : data) {
-        //d = static_cast<int>(rd());
-        d = static_cast<int>(dist());   // way faster on Linux
-    }
+    generate_input(data.data(), array_size, current_distribution, 1234);     // of --dist, uniform by default
 
     // std::stable_sort benchmarks
     printf("\n\n");
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::stable_sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         stable_sort(std::execution::seq, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial std::stable_sort", data, startTime, endTime);
     }
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::stable_sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         stable_sort(std::execution::unseq, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial SIMD std::stable_sort", data, startTime, endTime);
     }
 #endif
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::stable_sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         stable_sort(std::execution::par, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel std::stable_sort", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::stable_sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         stable_sort(std::execution::par_unseq, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::stable_sort", data, startTime, endTime);
     }
 
+    // Parallel stable merge sort (merge_sort.h): allocating its scratch buffer on every call like std::stable_sort does,
+    // and reusing one allocated (and paged in) before the timed region, as repeated sorts into the same buffers would
+
+    bool merge_sorted = false;
+    for (size_t i = 0; next_iteration("Parallel merge sort", i, num_times); i++)
+    {
+        copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
+
+        startTime = start_timer();
+        parallel_merge_sort(data_copy.data(), data_copy.data() + data_copy.size());
+        endTime = stop_timer();
+        print_results("Parallel merge sort", data, startTime, endTime);
+        merge_sorted = true;
+    }
+    auto equals_stable_sort = [&]()
+    {
+        bench_vector<int> reference(data.begin(), data.end());
+        stable_sort(std::execution::par, reference.begin(), reference.end());
+        return equal(std::execution::par, reference.begin(), reference.end(), data_copy.begin());
+    };
+    if (merge_sorted && !equals_stable_sort())
+        printf("Parallel merge sort: result differs from std::stable_sort!\n");
+
+    bench_vector<int> scratch(array_size);
+    bool scratch_merge_sorted = false;
+    for (size_t i = 0; next_iteration("Parallel merge sort reusing scratch", i, num_times); i++)
+    {
+        copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
+
+        startTime = start_timer();
+        parallel_merge_sort(data_copy.data(), data_copy.data() + data_copy.size(), scratch.data());
+        endTime = stop_timer();
+        print_results("Parallel merge sort reusing scratch", data, startTime, endTime);
+        scratch_merge_sorted = true;
+    }
+    if (scratch_merge_sorted && !equals_stable_sort())
+        printf("Parallel merge sort reusing scratch: result differs from std::stable_sort!\n");
+    if ((merge_sorted || scratch_merge_sorted) && !merge_sort_is_stable(data))
+        printf("Parallel merge sort: order of equal keys differs from std::stable_sort!\n");
+
     // dpl::stable_sort benchmarks
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::stable_sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         stable_sort(oneapi::dpl::execution::seq, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::stable_sort", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::stable_sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         stable_sort(oneapi::dpl::execution::unseq, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::stable_sort", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::stable_sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         stable_sort(oneapi::dpl::execution::par, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::stable_sort", data, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::stable_sort", i, num_times); i++)
     {
         copy(std::execution::par, data.begin(), data.end(), data_copy.begin());
 
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         stable_sort(oneapi::dpl::execution::par_unseq, data_copy.begin(), data_copy.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::stable_sort", data, startTime, endTime);
     }
 #endif
 }
 
-void merge_benchmark(size_t array_size, size_t num_times)
+// Merge path merge of parallel_merge.h: streaming stores chosen for merges larger than the last level cache, and either
+// kind forced. Each result is compared with the std::merge of the inputs, made once for the first row that ran
+void merge_path_rows(const int* a, size_t a_size, const int* b, size_t b_size, int* out, const bench_vector<int>& results, size_t num_times)
 {
-    std::vector<int>       data_int_src_0(array_size);
-    std::vector<int>       data_int_src_1(array_size);
-    std::vector<int>       data_int_dst(  2 * array_size, 1);   // initializate destination to page in and cache it
     high_resolution_clock::time_point startTime, endTime;
+    const char*     tags[]  = { "Parallel merge path merge", "Parallel merge path merge temporal stores", "Parallel merge path merge non-temporal stores" };
+    const StoreMode modes[] = { STORES_AUTO, STORES_TEMPORAL, STORES_NONTEMPORAL };
+    bench_vector<int> reference;
+    for (size_t m = 0; m < 3; m++)
+    {
+        bool merged = false;
+        for (size_t i = 0; next_iteration(tags[m], i, num_times); i++)
+        {
+            startTime = start_timer();
+            parallel_merge(a, a_size, b, b_size, out, modes[m]);
+            endTime = stop_timer();
+            print_results(tags[m], results, startTime, endTime);
+            merged = true;
+        }
+        if (!merged)
+            continue;
+        if (reference.empty())
+        {
+            reference.resize(a_size + b_size);
+            merge(std::execution::par, a, a + a_size, b, b + b_size, reference.begin());
+        }
+        if (!equal(std::execution::par, reference.begin(), reference.end(), out))
+            printf("%s: result differs from std::merge!\n", tags[m]);
+    }
+}
 
-    //random_device rd;
-    mt19937_64 dist(1234);
+void merge_benchmark(size_t array_size, size_t num_times)
+{
+    auto                    input_sizes = merge_input_sizes(2 * array_size, current_merge_ratio);     // of --merge-ratio, 1:1 by default
+    bench_vector<int>       data_int_src_0(input_sizes.first);
+    bench_vector<int>       data_int_src_1(input_sizes.second);
+    bench_vector<int>       data_int_dst(  2 * array_size, 1);   // initializate destination to page in and cache it
+    high_resolution_clock::time_point startTime, endTime;
 
     printf("\n\n");
 
-    for (auto& d : data_int_src_0) {
-        //d = static_cast<int>(rd());
-        d = static_cast<int>(dist());   // way faster on Linux
-    }
-    for (auto& d : data_int_src_1) {
-        //d = static_cast<int>(rd());
-        d = static_cast<int>(dist());   // way faster on Linux
-    }
+    generate_input(data_int_src_0.data(), data_int_src_0.size(), current_distribution, 1234);    // of --dist, uniform by default
+    generate_input(data_int_src_1.data(), data_int_src_1.size(), current_distribution, 1235);
 
     sort(std::execution::par, data_int_src_0.begin(), data_int_src_0.end());
     sort(std::execution::par, data_int_src_1.begin(), data_int_src_1.end());
 
     // std::merge benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(std::execution::seq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin(), data_int_src_1.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial std::merge", data_int_dst, startTime, endTime);
     }
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(std::execution::unseq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin(), data_int_src_1.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial SIMD std::merge", data_int_dst, startTime, endTime);
     }
 #endif
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(std::execution::par, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin(), data_int_src_1.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel std::merge", data_int_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(std::execution::par_unseq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin(), data_int_src_1.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::merge", data_int_dst, startTime, endTime);
     }
 
+    merge_path_rows(data_int_src_0.data(), data_int_src_0.size(), data_int_src_1.data(), data_int_src_1.size(), data_int_dst.data(), data_int_dst, num_times);
+
     // dpl::stable_sort benchmarks
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(oneapi::dpl::execution::seq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin(), data_int_src_1.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::merge", data_int_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(oneapi::dpl::execution::unseq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin(), data_int_src_1.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::merge", data_int_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(oneapi::dpl::execution::par, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin(), data_int_src_1.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::merge", data_int_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(oneapi::dpl::execution::par_unseq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin(), data_int_src_1.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::merge", data_int_dst, startTime, endTime);
     }
 
@@ -807,148 +1028,163 @@ void merge_benchmark(size_t array_size, size_t num_times)
 
 void inplace_merge_benchmark(size_t array_size, size_t num_times)
 {
-    std::vector<int> data_int( array_size * 2);
-    std::vector<int> data_copy(array_size * 2);
+    bench_vector<int> data_int( array_size * 2);
+    bench_vector<int> data_copy(array_size * 2);
     high_resolution_clock::time_point startTime, endTime;
+    const size_t left_size = merge_input_sizes(2 * array_size, current_merge_ratio).first;   // of --merge-ratio, 1:1 by default
 
-    //random_device rd;
-    mt19937_64 dist(1234);
-
-    for (auto& d : data_int) {
-        //d = static_cast<int>(rd());
-        d = static_cast<int>(dist());   // way faster on Linux
-    }
+    generate_input(data_int.data(), data_int.size(), current_distribution, 1234);    // of --dist, uniform by default
 
     printf("\n\n");
 
     // std::inplace_merge benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::inplace_merge", i, num_times); i++)
     {
         copy(std::execution::par, data_int.begin(), data_int.end(), data_copy.begin());
 
-        sort(std::execution::par, data_copy.begin(), data_copy.begin() + data_copy.size() / 2);  // left  half
-        sort(std::execution::par, data_copy.begin() + data_copy.size() / 2, data_copy.end());    // right half
+        sort(std::execution::par, data_copy.begin(), data_copy.begin() + left_size);  // left  half
+        sort(std::execution::par, data_copy.begin() + left_size, data_copy.end());    // right half
 
-        startTime = high_resolution_clock::now();
-        inplace_merge(std::execution::seq, data_copy.begin(), data_copy.begin() + data_copy.size() / 2, data_copy.end());
-        endTime = high_resolution_clock::now();
+        startTime = start_timer();
+        inplace_merge(std::execution::seq, data_copy.begin(), data_copy.begin() + left_size, data_copy.end());
+        endTime = stop_timer();
         print_results("Serial std::inplace_merge", data_int, startTime, endTime);
     }
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::inplace_merge", i, num_times); i++)
     {
         copy(std::execution::par, data_int.begin(), data_int.end(), data_copy.begin());
 
-        sort(std::execution::par, data_copy.begin(), data_copy.begin() + data_copy.size() / 2);  // left  half
-        sort(std::execution::par, data_copy.begin() + data_copy.size() / 2, data_copy.end());    // right half
+        sort(std::execution::par, data_copy.begin(), data_copy.begin() + left_size);  // left  half
+        sort(std::execution::par, data_copy.begin() + left_size, data_copy.end());    // right half
 
-        startTime = high_resolution_clock::now();
-        inplace_merge(std::execution::unseq, data_copy.begin(), data_copy.begin() + data_copy.size() / 2, data_copy.end());
-        endTime = high_resolution_clock::now();
+        startTime = start_timer();
+        inplace_merge(std::execution::unseq, data_copy.begin(), data_copy.begin() + left_size, data_copy.end());
+        endTime = stop_timer();
         print_results("Serial SIMD std::inplace_merge", data_int, startTime, endTime);
     }
 #endif
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::inplace_merge", i, num_times); i++)
     {
         copy(std::execution::par, data_int.begin(), data_int.end(), data_copy.begin());
 
-        sort(std::execution::par, data_copy.begin(), data_copy.begin() + data_copy.size() / 2);  // left  half
-        sort(std::execution::par, data_copy.begin() + data_copy.size() / 2, data_copy.end());    // right half
+        sort(std::execution::par, data_copy.begin(), data_copy.begin() + left_size);  // left  half
+        sort(std::execution::par, data_copy.begin() + left_size, data_copy.end());    // right half
 
-        startTime = high_resolution_clock::now();
-        inplace_merge(std::execution::par, data_copy.begin(), data_copy.begin() + data_copy.size() / 2, data_copy.end());
-        endTime = high_resolution_clock::now();
+        startTime = start_timer();
+        inplace_merge(std::execution::par, data_copy.begin(), data_copy.begin() + left_size, data_copy.end());
+        endTime = stop_timer();
         print_results("Parallel std::inplace_merge", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::inplace_merge", i, num_times); i++)
     {
         copy(std::execution::par, data_int.begin(), data_int.end(), data_copy.begin());
 
-        sort(std::execution::par, data_copy.begin(), data_copy.begin() + data_copy.size() / 2);  // left  half
-        sort(std::execution::par, data_copy.begin() + data_copy.size() / 2, data_copy.end());    // right half
+        sort(std::execution::par, data_copy.begin(), data_copy.begin() + left_size);  // left  half
+        sort(std::execution::par, data_copy.begin() + left_size, data_copy.end());    // right half
 
-        startTime = high_resolution_clock::now();
-        inplace_merge(std::execution::par_unseq, data_copy.begin(), data_copy.begin() + data_copy.size() / 2, data_copy.end());
-        endTime = high_resolution_clock::now();
+        startTime = start_timer();
+        inplace_merge(std::execution::par_unseq, data_copy.begin(), data_copy.begin() + left_size, data_copy.end());
+        endTime = stop_timer();
         print_results("Parallel SIMD std::inplace_merge", data_int, startTime, endTime);
     }
 
+    // Parallel in-place merge (inplace_merge.h), with a fixed workspace per chunk instead of a buffer of half the array
+
+    bool bounded_merged = false;
+    for (size_t i = 0; next_iteration("Parallel bounded workspace inplace_merge", i, num_times); i++)
+    {
+        copy(std::execution::par, data_int.begin(), data_int.end(), data_copy.begin());
+
+        sort(std::execution::par, data_copy.begin(), data_copy.begin() + left_size);  // left  half
+        sort(std::execution::par, data_copy.begin() + left_size, data_copy.end());    // right half
+
+        startTime = start_timer();
+        parallel_inplace_merge(data_copy.data(), data_copy.data() + left_size, data_copy.data() + data_copy.size());
+        endTime = stop_timer();
+        print_results("Parallel bounded workspace inplace_merge", data_int, startTime, endTime);
+        bounded_merged = true;
+    }
+    if (bounded_merged)
+    {
+        bench_vector<int> reference(data_int.begin(), data_int.end());
+        sort(std::execution::par, reference.begin(), reference.begin() + left_size);
+        sort(std::execution::par, reference.begin() + left_size, reference.end());
+        inplace_merge(std::execution::par, reference.begin(), reference.begin() + left_size, reference.end());
+        if (!equal(std::execution::par, reference.begin(), reference.end(), data_copy.begin()))
+            printf("Parallel bounded workspace inplace_merge: result differs from std::inplace_merge!\n");
+    }
+
     // dpl::stable_sort benchmarks
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::inplace_merge", i, num_times); i++)
     {
         copy(std::execution::par, data_int.begin(), data_int.end(), data_copy.begin());
 
-        sort(std::execution::par, data_copy.begin(), data_copy.begin() + data_copy.size() / 2);  // left  half
-        sort(std::execution::par, data_copy.begin() + data_copy.size() / 2, data_copy.end());    // right half
+        sort(std::execution::par, data_copy.begin(), data_copy.begin() + left_size);  // left  half
+        sort(std::execution::par, data_copy.begin() + left_size, data_copy.end());    // right half
 
-        startTime = high_resolution_clock::now();
-        inplace_merge(oneapi::dpl::execution::seq, data_copy.begin(), data_copy.begin() + data_copy.size() / 2, data_copy.end());
-        endTime = high_resolution_clock::now();
+        startTime = start_timer();
+        inplace_merge(oneapi::dpl::execution::seq, data_copy.begin(), data_copy.begin() + left_size, data_copy.end());
+        endTime = stop_timer();
         print_results("Serial dpl::inplace_merge", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::inplace_merge", i, num_times); i++)
     {
         copy(std::execution::par, data_int.begin(), data_int.end(), data_copy.begin());
 
-        sort(std::execution::par, data_copy.begin(), data_copy.begin() + data_copy.size() / 2);  // left  half
-        sort(std::execution::par, data_copy.begin() + data_copy.size() / 2, data_copy.end());    // right half
+        sort(std::execution::par, data_copy.begin(), data_copy.begin() + left_size);  // left  half
+        sort(std::execution::par, data_copy.begin() + left_size, data_copy.end());    // right half
 
-        startTime = high_resolution_clock::now();
-        inplace_merge(oneapi::dpl::execution::unseq, data_copy.begin(), data_copy.begin() + data_copy.size() / 2, data_copy.end());
-        endTime = high_resolution_clock::now();
+        startTime = start_timer();
+        inplace_merge(oneapi::dpl::execution::unseq, data_copy.begin(), data_copy.begin() + left_size, data_copy.end());
+        endTime = stop_timer();
         print_results("SIMD dpl::inplace_merge", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::inplace_merge", i, num_times); i++)
     {
         copy(std::execution::par, data_int.begin(), data_int.end(), data_copy.begin());
 
-        sort(std::execution::par, data_copy.begin(), data_copy.begin() + data_copy.size() / 2);  // left  half
-        sort(std::execution::par, data_copy.begin() + data_copy.size() / 2, data_copy.end());    // right half
+        sort(std::execution::par, data_copy.begin(), data_copy.begin() + left_size);  // left  half
+        sort(std::execution::par, data_copy.begin() + left_size, data_copy.end());    // right half
 
-        startTime = high_resolution_clock::now();
-        inplace_merge(oneapi::dpl::execution::par, data_copy.begin(), data_copy.begin() + data_copy.size() / 2, data_copy.end());
-        endTime = high_resolution_clock::now();
+        startTime = start_timer();
+        inplace_merge(oneapi::dpl::execution::par, data_copy.begin(), data_copy.begin() + left_size, data_copy.end());
+        endTime = stop_timer();
         print_results("Parallel dpl::inplace_merge", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::inplace_merge", i, num_times); i++)
     {
         copy(std::execution::par, data_int.begin(), data_int.end(), data_copy.begin());
 
-        sort(std::execution::par, data_copy.begin(), data_copy.begin() + data_copy.size() / 2);  // left  half
-        sort(std::execution::par, data_copy.begin() + data_copy.size() / 2, data_copy.end());    // right half
+        sort(std::execution::par, data_copy.begin(), data_copy.begin() + left_size);  // left  half
+        sort(std::execution::par, data_copy.begin() + left_size, data_copy.end());    // right half
 
-        startTime = high_resolution_clock::now();
-        inplace_merge(oneapi::dpl::execution::par_unseq, data_copy.begin(), data_copy.begin() + data_copy.size() / 2, data_copy.end());
-        endTime = high_resolution_clock::now();
+        startTime = start_timer();
+        inplace_merge(oneapi::dpl::execution::par_unseq, data_copy.begin(), data_copy.begin() + left_size, data_copy.end());
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::inplace_merge", data_int, startTime, endTime);
     }
 
 #endif
 }
 
-void merge_dual_buffer_benchmark(size_t array_size, int num_times)
+void merge_dual_buffer_benchmark(size_t array_size, size_t num_times)
 {
-    std::vector<int>       data_int_src(2 * array_size);
-    std::vector<int>       data_int_dst(2 * array_size);
+    bench_vector<int>       data_int_src(2 * array_size);
+    bench_vector<int>       data_int_dst(2 * array_size);
     high_resolution_clock::time_point startTime, endTime;
 
-    random_device rd;
-
     printf("\n\n");
 
-    for (auto& d : data_int_src) {
-        d = static_cast<int>(rd());
-    }
-    for (auto& d : data_int_dst) {
-        d = static_cast<int>(rd());
-    }
+    generate_input(data_int_src.data(), data_int_src.size(), current_distribution, 1234);    // of --dist, uniform by default
+    generate_input(data_int_dst.data(), data_int_dst.size(), current_distribution, 1235);
 
     sort(std::execution::par, data_int_src.begin(), data_int_src.begin() + array_size);
     sort(std::execution::par, data_int_src.begin() + array_size, data_int_src.begin() + 2 * array_size);
@@ -956,74 +1192,76 @@ void merge_dual_buffer_benchmark(size_t array_size, int num_times)
 
     // std::merge benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial single array std::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(std::execution::seq, data_int_src.begin(),              data_int_src.begin() + array_size,
                                    data_int_src.begin() + array_size, data_int_src.begin() + 2 * array_size, data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial single array std::merge", data_int_dst, startTime, endTime);
     }
 
-    //startTime = high_resolution_clock::now();
+    //startTime = start_timer();
     //merge(std::execution::unseq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin(), data_int_src_1.end(), data_int_dst.begin());
-    //endTime = high_resolution_clock::now();
+    //endTime = stop_timer();
     //print_results("SIMD std::merge", data_int_dst, startTime, endTime);
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel single array std::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(std::execution::par, data_int_src.begin(), data_int_src.begin() + array_size,
                                    data_int_src.begin() + array_size, data_int_src.begin() + 2 * array_size, data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel single array std::merge", data_int_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(std::execution::par_unseq, data_int_src.begin(), data_int_src.begin() + array_size,
                                          data_int_src.begin() + array_size, data_int_src.begin() + 2 * array_size, data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::merge", data_int_dst, startTime, endTime);
     }
 
+    merge_path_rows(data_int_src.data(), array_size, data_int_src.data() + array_size, array_size, data_int_dst.data(), data_int_dst, num_times);
+
     // dpl::stable_sort benchmarks
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(oneapi::dpl::execution::seq, data_int_src.begin(), data_int_src.begin() + array_size,
                                            data_int_src.begin() + array_size, data_int_src.begin() + 2 * array_size, data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::merge", data_int_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(oneapi::dpl::execution::unseq, data_int_src.begin(), data_int_src.begin() + array_size,
                                              data_int_src.begin() + array_size, data_int_src.begin() + 2 * array_size, data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::merge", data_int_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(oneapi::dpl::execution::par, data_int_src.begin(), data_int_src.begin() + array_size,
                                            data_int_src.begin() + array_size, data_int_src.begin() + 2 * array_size, data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::merge", data_int_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(oneapi::dpl::execution::par_unseq, data_int_src.begin(), data_int_src.begin() + array_size,
                                                  data_int_src.begin() + array_size, data_int_src.begin() + 2 * array_size, data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::merge", data_int_dst, startTime, endTime);
     }
 
@@ -1031,27 +1269,23 @@ void merge_dual_buffer_benchmark(size_t array_size, int num_times)
 
 #endif
 
-    //for (size_t i = 0; i < num_times; i++)
+    //for (size_t i = 0; next_iteration("Parallel Victor's merge", i, num_times); i++)
     //{
-    //    startTime = high_resolution_clock::now();
+    //    startTime = start_timer();
     //    merge_parallel_L5(data_int_src.data(), 0, array_size - 1, array_size, 2 * array_size - 1, data_int_dst.data(), 0);
-    //    endTime = high_resolution_clock::now();
+    //    endTime = stop_timer();
     //    print_results("Parallel Victor's merge", data_int_dst, startTime, endTime);
     //}
 
 }
-void merge_single_buffer_benchmark(size_t array_size, int num_times)
+void merge_single_buffer_benchmark(size_t array_size, size_t num_times)
 {
-    std::vector<int>       data_int_src_dst(4 * array_size);
+    bench_vector<int>       data_int_src_dst(4 * array_size);
     high_resolution_clock::time_point startTime, endTime;
 
-    random_device rd;
-
     printf("\n\n");
 
-    for (auto& d : data_int_src_dst) {
-        d = static_cast<int>(rd());
-    }
+    generate_input(data_int_src_dst.data(), data_int_src_dst.size(), current_distribution, 1234);    // of --dist, uniform by default
 
     sort(std::execution::par, data_int_src_dst.begin(), data_int_src_dst.begin() + array_size);
     sort(std::execution::par, data_int_src_dst.begin() + array_size, data_int_src_dst.begin() + 2 * array_size);
@@ -1059,168 +1293,187 @@ void merge_single_buffer_benchmark(size_t array_size, int num_times)
 
     // std::merge benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial single array std::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(std::execution::seq, data_int_src_dst.begin(), data_int_src_dst.begin() + array_size,
                                    data_int_src_dst.begin() + array_size, data_int_src_dst.begin() + 2 * array_size, data_int_src_dst.begin() + 2 * array_size);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial single array std::merge", data_int_src_dst, startTime, endTime);
     }
 
-    //startTime = high_resolution_clock::now();
+    //startTime = start_timer();
     //merge(std::execution::unseq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin(), data_int_src_1.end(), data_int_dst.begin());
-    //endTime = high_resolution_clock::now();
+    //endTime = stop_timer();
     //print_results("SIMD std::merge", data_int_dst, startTime, endTime);
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel single array std::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(std::execution::par, data_int_src_dst.begin(), data_int_src_dst.begin() + array_size,
                                    data_int_src_dst.begin() + array_size, data_int_src_dst.begin() + 2 * array_size, data_int_src_dst.begin() + 2 * array_size);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel single array std::merge", data_int_src_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(std::execution::par_unseq, data_int_src_dst.begin(), data_int_src_dst.begin() + array_size,
                                          data_int_src_dst.begin() + array_size, data_int_src_dst.begin() + 2 * array_size, data_int_src_dst.begin() + 2 * array_size);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::merge", data_int_src_dst, startTime, endTime);
     }
 
+    merge_path_rows(data_int_src_dst.data(), array_size, data_int_src_dst.data() + array_size, array_size, data_int_src_dst.data() + 2 * array_size,
+                    data_int_src_dst, num_times);
+
     // dpl::stable_sort benchmarks
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(oneapi::dpl::execution::seq, data_int_src_dst.begin(), data_int_src_dst.begin() + array_size,
                                            data_int_src_dst.begin() + array_size, data_int_src_dst.begin() + 2 * array_size, data_int_src_dst.begin() + 2 * array_size);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::merge", data_int_src_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(oneapi::dpl::execution::unseq, data_int_src_dst.begin(), data_int_src_dst.begin() + array_size,
                                              data_int_src_dst.begin() + array_size, data_int_src_dst.begin() + 2 * array_size, data_int_src_dst.begin() + 2 * array_size);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::merge", data_int_src_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(oneapi::dpl::execution::par, data_int_src_dst.begin(), data_int_src_dst.begin() + array_size,
                                            data_int_src_dst.begin() + array_size, data_int_src_dst.begin() + 2 * array_size, data_int_src_dst.begin() + 2 * array_size);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::merge", data_int_src_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::merge", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         merge(oneapi::dpl::execution::par_unseq, data_int_src_dst.begin(), data_int_src_dst.begin() + array_size,
                                                  data_int_src_dst.begin() + array_size, data_int_src_dst.begin() + 2 * array_size, data_int_src_dst.begin() + 2 * array_size);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::merge", data_int_src_dst, startTime, endTime);
     }
 #endif
 
-    //for (size_t i = 0; i < num_times; i++)
+    //for (size_t i = 0; next_iteration("Parallel Victor's merge", i, num_times); i++)
     //{
-    //    startTime = high_resolution_clock::now();
+    //    startTime = start_timer();
     //    merge_parallel_L5(data_int_src_dst.data(), 0, array_size - 1, array_size, 2 * array_size - 1, data_int_src_dst.data(), 2 * array_size);
-    //    endTime = high_resolution_clock::now();
+    //    endTime = stop_timer();
     //    print_results("Parallel Victor's merge", data_int_src_dst, startTime, endTime);
     //}
 }
 
 void all_of_benchmark(size_t array_size, size_t num_times)
 {
-    std::vector<int> data_int(array_size, 2);
+    bench_vector<int> data_int(array_size, 2);
     high_resolution_clock::time_point startTime, endTime;
 
     printf("\n\n");
 
+    const size_t first_mismatch = match_index(array_size, current_match);     // of --match, none by default
+    if (first_mismatch < array_size)
+        data_int[first_mismatch] = 3;
+
     // std::inplace_merge benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::all_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (all_of(std::execution::seq, data_int.begin(), data_int.end(), [](int i) { return i == 2; }))
             printf("All numbers in the array are equal to 2\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial std::all_of", data_int, startTime, endTime);
     }
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::all_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (all_of(std::execution::unseq, data_int.begin(), data_int.end(), [](int i) { return i == 2; }))
             printf("All numbers in the array are equal to 2\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial SIMD std::all_of", data_int, startTime, endTime);
     }
 #endif
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::all_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (all_of(std::execution::par, data_int.begin(), data_int.end(), [](int i) { return i == 2; }))
             printf("All numbers in the array are equal to 2\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel std::all_of", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::all_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (all_of(std::execution::par_unseq, data_int.begin(), data_int.end(), [](int i) { return i == 2; }))
             printf("All numbers in the array are equal to 2\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::all_of", data_int, startTime, endTime);
     }
 
+    // Search of early_exit_search.h, which stops every worker once a mismatch is found
+
+    for (size_t i = 0; next_iteration("Parallel early exit all_of", i, num_times); i++)
+    {
+        startTime = start_timer();
+        bool all = parallel_early_exit_all_of(data_int.data(), data_int.size(), [](int i) { return i == 2; });
+        endTime = stop_timer();
+        print_results("Parallel early exit all_of", data_int, startTime, endTime);
+        if (all != (first_mismatch == array_size))
+            printf("Parallel early exit all_of: wrong result!\n");
+    }
+
     // dpl::stable_sort benchmarks
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::all_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (all_of(oneapi::dpl::execution::seq, data_int.begin(), data_int.end(), [](int i) { return i == 2; }))
             printf("All numbers in the array are equal to 2\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::all_of", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::all_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (all_of(oneapi::dpl::execution::unseq, data_int.begin(), data_int.end(), [](int i) { return i == 2; }))
             printf("All numbers in the array are equal to 2\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::all_of", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::all_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (all_of(oneapi::dpl::execution::par, data_int.begin(), data_int.end(), [](int i) { return i == 2; }))
             printf("All numbers in the array are equal to 2\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::all_of", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::all_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (all_of(oneapi::dpl::execution::par_unseq, data_int.begin(), data_int.end(), [](int i) { return i == 2; }))
             printf("All numbers in the array are equal to 2\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::all_of", data_int, startTime, endTime);
     }
 #endif
@@ -1228,85 +1481,101 @@ void all_of_benchmark(size_t array_size, size_t num_times)
 
 void any_of_benchmark(size_t array_size, size_t num_times)
 {
-    std::vector<int> data_int(array_size, 2);
+    bench_vector<int> data_int(array_size, 2);
     high_resolution_clock::time_point startTime, endTime;
 
     printf("\n\n");
 
+    const size_t first_match = match_index(array_size, current_match);    // of --match, none by default
+    if (first_match < array_size)
+        data_int[first_match] = 3;
+
     // std::inplace_merge benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::any_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (!any_of(std::execution::seq, data_int.begin(), data_int.end(), [](int i) { return i == 3; }))
             printf("No numbers in the array are equal to 3\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial std::any_of", data_int, startTime, endTime);
     }
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::any_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (!any_of(std::execution::unseq, data_int.begin(), data_int.end(), [](int i) { return i == 3; }))
             printf("No numbers in the array are equal to 3\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial SIMD std::any_of", data_int, startTime, endTime);
     }
 #endif
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::any_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (!any_of(std::execution::par, data_int.begin(), data_int.end(), [](int i) { return i == 3; }))
             printf("No numbers in the array are equal to 3\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel std::any_of", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::any_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (!any_of(std::execution::par_unseq, data_int.begin(), data_int.end(), [](int i) { return i == 3; }))
             printf("No numbers in the array are equal to 3\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::any_of", data_int, startTime, endTime);
     }
 
+    // Search of early_exit_search.h, which stops every worker once a match is found
+
+    for (size_t i = 0; next_iteration("Parallel early exit any_of", i, num_times); i++)
+    {
+        startTime = start_timer();
+        bool any = parallel_early_exit_any_of(data_int.data(), data_int.size(), [](int i) { return i == 3; });
+        endTime = stop_timer();
+        print_results("Parallel early exit any_of", data_int, startTime, endTime);
+        if (any != (first_match < array_size))
+            printf("Parallel early exit any_of: wrong result!\n");
+    }
+
     // dpl::stable_sort benchmarks
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::any_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (!any_of(oneapi::dpl::execution::seq, data_int.begin(), data_int.end(), [](int i) { return i == 3; }))
             printf("No numbers in the array are equal to 3\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::any_of", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::any_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (!any_of(oneapi::dpl::execution::unseq, data_int.begin(), data_int.end(), [](int i) { return i == 3; }))
             printf("No numbers in the array are equal to 3\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::any_of", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::any_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (!any_of(oneapi::dpl::execution::par, data_int.begin(), data_int.end(), [](int i) { return i == 3; }))
             printf("No numbers in the array are equal to 3\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::any_of", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::any_of", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (!any_of(oneapi::dpl::execution::par_unseq, data_int.begin(), data_int.end(), [](int i) { return i == 3; }))
             printf("No numbers in the array are equal to 3\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::any_of", data_int, startTime, endTime);
     }
 #endif
@@ -1314,8 +1583,8 @@ void any_of_benchmark(size_t array_size, size_t num_times)
 
 void copy_benchmark(size_t array_size, size_t num_times)
 {
-    std::vector<int>       data_int_src(array_size);
-    std::vector<int>       data_int_dst(array_size);
+    bench_vector<int>       data_int_src(array_size);
+    bench_vector<int>       data_int_dst(array_size);
     high_resolution_clock::time_point startTime, endTime;
 
     printf("\n\n");
@@ -1332,170 +1601,253 @@ void copy_benchmark(size_t array_size, size_t num_times)
 
     // std::merge benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::copy", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         copy(std::execution::seq, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial std::copy", data_int_dst, startTime, endTime);
     }
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::copy", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         copy(std::execution::unseq, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial SIMD std::copy", data_int_dst, startTime, endTime);
     }
 #endif
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::copy", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         copy(std::execution::par, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel std::copy", data_int_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::copy", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         copy(std::execution::par_unseq, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::copy", data_int_dst, startTime, endTime);
     }
 
+    // Vector copy of streaming_stores.h: streaming stores chosen for copies larger than the last level cache, and either kind forced
+
+    const char* streaming_copy_tags[] = { "Parallel streaming copy", "Parallel streaming copy temporal stores", "Parallel streaming copy non-temporal stores" };
+    const StoreMode streaming_copy_modes[] = { STORES_AUTO, STORES_TEMPORAL, STORES_NONTEMPORAL };
+    for (size_t m = 0; m < 3; m++)
+    {
+        bool copied = false;
+        for (size_t i = 0; next_iteration(streaming_copy_tags[m], i, num_times); i++)
+        {
+            fill(std::execution::par, data_int_dst.begin(), data_int_dst.end(), 0);
+
+            startTime = start_timer();
+            parallel_copy_streaming(data_int_src.data(), data_int_src.size(), data_int_dst.data(), streaming_copy_modes[m]);
+            endTime = stop_timer();
+            print_results(streaming_copy_tags[m], data_int_dst, startTime, endTime);
+            copied = true;
+        }
+        if (copied && !equal(std::execution::par, data_int_src.begin(), data_int_src.end(), data_int_dst.begin()))
+            printf("%s: copy differs from the source!\n", streaming_copy_tags[m]);
+    }
+
     // dpl::stable_sort benchmarks
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::copy", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         copy(oneapi::dpl::execution::seq, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::copy", data_int_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::copy", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         copy(oneapi::dpl::execution::unseq, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::copy", data_int_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::copy", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         copy(oneapi::dpl::execution::par, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::copy", data_int_dst, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::copy", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         copy(oneapi::dpl::execution::par_unseq, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::copy", data_int_dst, startTime, endTime);
     }
 
 #endif
 }
 
+// Time of a cache-resident workload (a serial sum over half of the last level cache) right after a copy of array_size
+// elements, which shows how much of the cache the copy evicted. Regular stores fill the cache with the destination,
+// while streaming stores leave it to the workload that runs next. The streaming copy picks its stores by size, so rows
+// forcing each kind show both at every size. The harness leaves the caches alone (cache_control is off), since
+// flushing them before the timed sum would undo what the copy did to them
+void copy_follow_up_benchmark(size_t array_size, size_t num_times)
+{
+    bench_vector<int> data_int_src(array_size);
+    bench_vector<int> data_int_dst(array_size);
+    bench_vector<int> resident(std::max(last_level_cache_size() / 2 / sizeof(int), (size_t)1));
+    high_resolution_clock::time_point startTime, endTime;
+
+    printf("\n\n");
+
+    for (size_t i = 0; i < array_size; i++)
+        data_int_src[i] = (int)i;
+    for (size_t i = 0; i < resident.size(); i++)
+        resident[i] = (int)(i & 0xFF);
+    const long long expected = accumulate(resident.begin(), resident.end(), 0LL);
+
+    // The timed sum is serial, so are the tags: the copies before it are untimed, and thread sweeps do not rerun the rows
+    const char* tags[] = { "Serial resident sum without copy", "Serial resident sum after parallel std::copy", "Serial resident sum after parallel streaming copy",
+                           "Serial resident sum after parallel streaming copy temporal stores", "Serial resident sum after parallel streaming copy non-temporal stores" };
+    const StoreMode modes[] = { STORES_AUTO, STORES_AUTO, STORES_AUTO, STORES_TEMPORAL, STORES_NONTEMPORAL };     // of the streaming copies
+    for (size_t t = 0; t < 5; t++)
+    {
+        for (size_t i = 0; next_iteration(tags[t], i, num_times); i++)
+        {
+            long long warm = accumulate(resident.begin(), resident.end(), 0LL);     // bring the workload into the cache
+            if (t == 1)
+                copy(std::execution::par, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
+            else if (t >= 2)
+                parallel_copy_streaming(data_int_src.data(), data_int_src.size(), data_int_dst.data(), modes[t]);
+
+            startTime = start_timer();
+            long long sum = accumulate(resident.begin(), resident.end(), 0LL);
+            endTime = stop_timer();
+            if (sum != expected || warm != expected)
+                printf("%s: wrong sum %lld\n", tags[t], sum);
+            print_results(tags[t], resident, startTime, endTime);
+        }
+    }
+}
+
 void equal_benchmark(size_t array_size, size_t num_times)
 {
-    std::vector<int>       data_int_src_0(100000000, 0);
-    std::vector<int>       data_int_src_1(100000000, 0);
+    bench_vector<int>       data_int_src_0(array_size, 0);
+    bench_vector<int>       data_int_src_1(array_size, 0);
     high_resolution_clock::time_point startTime, endTime;
 
     printf("\n\n");
 
+    const size_t first_mismatch = match_index(array_size, current_match);     // of --match, none by default
+    if (first_mismatch < array_size)
+        data_int_src_1[first_mismatch] = 1;
+    const bool   expected       = first_mismatch == array_size;
+
     // std::equal benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::equal", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         bool equals = equal(std::execution::seq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin());
-        endTime = high_resolution_clock::now();
-        if (equals)
+        endTime = stop_timer();
+        if (equals == expected)
             print_results("Serial std::equal", data_int_src_0, startTime, endTime);
         else
             exit(1);
     }
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::equal", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         if (equal(std::execution::unseq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin()))
             printf("Arrays are equal\n");
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial SIMD std::equal", data_int_src_0, startTime, endTime);
     }
 #endif
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::equal", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         bool equals = equal(std::execution::par, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin());
-        endTime = high_resolution_clock::now();
-        if (equals)
+        endTime = stop_timer();
+        if (equals == expected)
             print_results("Parallel std::equal", data_int_src_0, startTime, endTime);
         else
             exit(1);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::equal", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         bool equals = equal(std::execution::par_unseq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin());
-        endTime = high_resolution_clock::now();
-        if (equals)
+        endTime = stop_timer();
+        if (equals == expected)
             print_results("Parallel SIMD std::equal", data_int_src_0, startTime, endTime);
         else
             exit(1);
     }
 
+    // Search of early_exit_search.h, which stops every worker once a mismatch is found
+
+    for (size_t i = 0; next_iteration("Parallel early exit equal", i, num_times); i++)
+    {
+        startTime = start_timer();
+        bool equals = parallel_early_exit_equal(data_int_src_0.data(), data_int_src_1.data(), array_size);
+        endTime = stop_timer();
+        if (equals == expected)
+            print_results("Parallel early exit equal", data_int_src_0, startTime, endTime);
+        else
+            exit(1);
+    }
+
     // dpl::stable_sort benchmarks
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::equal", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         bool equals = equal(oneapi::dpl::execution::seq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin());
-        endTime = high_resolution_clock::now();
-        if (equals)
+        endTime = stop_timer();
+        if (equals == expected)
             print_results("Serial dpl::equal", data_int_src_0, startTime, endTime);
         else
             exit(1);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::equal", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         bool equals = equal(oneapi::dpl::execution::unseq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin());
-        endTime = high_resolution_clock::now();
-        if (equals)
+        endTime = stop_timer();
+        if (equals == expected)
             print_results("SIMD dpl::equal", data_int_src_0, startTime, endTime);
         else
             exit(1);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::equal", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         bool equals = equal(oneapi::dpl::execution::par, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin());
-        endTime = high_resolution_clock::now();
-        if (equals)
+        endTime = stop_timer();
+        if (equals == expected)
             print_results("Parallel dpl::equal", data_int_src_0, startTime, endTime);
         else
             exit(1);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::equal", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         bool equals = equal(oneapi::dpl::execution::par_unseq, data_int_src_0.begin(), data_int_src_0.end(), data_int_src_1.begin());
-        endTime = high_resolution_clock::now();
-        if (equals)
+        endTime = stop_timer();
+        if (equals == expected)
             print_results("Parallel SIMD dpl::equal", data_int_src_0, startTime, endTime);
         else
             exit(1);
@@ -1506,7 +1858,7 @@ void equal_benchmark(size_t array_size, size_t num_times)
 
 void count_benchmark(size_t array_size, size_t num_times)
 {
-    std::vector<int>       data_int_src(array_size);
+    bench_vector<int>       data_int_src(array_size);
     size_t                 num_items;
     high_resolution_clock::time_point startTime, endTime;
 
@@ -1522,70 +1874,88 @@ void count_benchmark(size_t array_size, size_t num_times)
 
     // std::count benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::count", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         num_items = count(std::execution::seq, data_int_src.begin(), data_int_src.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial std::count", num_items, data_int_src, startTime, endTime);
     }
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::count", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         num_items = count(std::execution::unseq, data_int_src.begin(), data_int_src.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial SIMD std::count", num_items, data_int_src, startTime, endTime);
     }
 #endif
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::count", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         num_items = count(std::execution::par, data_int_src.begin(), data_int_src.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel std::count", num_items, data_int_src, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::count", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         num_items = count(std::execution::par_unseq, data_int_src.begin(), data_int_src.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::count", num_items, data_int_src, startTime, endTime);
     }
 
+    // Hand-vectorized kernels of simd_reductions.h, the widest the CPU supports
+
+    const size_t std_num_items = count(std::execution::par, data_int_src.begin(), data_int_src.end(), 42);
+    const char* kernel_count_tags[] = { "Serial SIMD kernel count", "Parallel SIMD kernel count" };
+    for (size_t k = 0; k < 2; k++)
+    {
+        for (size_t i = 0; next_iteration(kernel_count_tags[k], i, num_times); i++)
+        {
+            startTime = start_timer();
+            num_items = k == 0 ? simd_count(data_int_src.data(), data_int_src.size(), 42)
+                               : parallel_simd_count(data_int_src.data(), data_int_src.size(), 42);
+            endTime = stop_timer();
+            print_results(kernel_count_tags[k], num_items, data_int_src, startTime, endTime);
+            if (num_items != std_num_items)
+                printf("%s: count %zu differs from std::count %zu!\n", kernel_count_tags[k], num_items, std_num_items);
+        }
+    }
+
     // dpl::count benchmarks
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::count", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         num_items = count(oneapi::dpl::execution::seq, data_int_src.begin(), data_int_src.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::count", num_items, data_int_src, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::count", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         num_items = count(oneapi::dpl::execution::unseq, data_int_src.begin(), data_int_src.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::count", num_items, data_int_src, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::count", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         num_items = count(oneapi::dpl::execution::par, data_int_src.begin(), data_int_src.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::count", num_items, data_int_src, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::count", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         num_items = count(oneapi::dpl::execution::par_unseq, data_int_src.begin(), data_int_src.end(), 42);
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::count", num_items, data_int_src, startTime, endTime);
     }
 
@@ -1594,7 +1964,7 @@ void count_benchmark(size_t array_size, size_t num_times)
 
 void adjacent_find_benchmark(size_t array_size, size_t num_times)
 {
-    std::vector<int>       data_int(array_size, 2);
+    bench_vector<int>       data_int(array_size, 2);
     high_resolution_clock::time_point startTime, endTime;
 
     printf("\nAdjacent Find\n");
@@ -1604,79 +1974,97 @@ void adjacent_find_benchmark(size_t array_size, size_t num_times)
         if (i % 2 == 0)
             data_int[i] = 3;
     }
+    size_t first_pair = match_index(array_size, current_match);     // of --match, none by default
+    if (first_pair + 1 < array_size)
+        data_int[first_pair + 1] = data_int[first_pair];
+    else
+        first_pair = array_size;
 
     // std::adjacent_find benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::adjacent_find", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         auto iequal = adjacent_find (std::execution::seq, data_int.begin(), data_int.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         if (iequal == data_int.end()) printf("No equal pairs found\n");
         print_results("Serial std::adjacent_find", data_int, startTime, endTime);
     }
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::adjacent_find", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         auto iequal = adjacent_find(std::execution::unseq, data_int.begin(), data_int.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         if (iequal == data_int.end()) printf("No equal pairs found\n");
         print_results("Serial SIMD std::adjacent_find", data_int, startTime, endTime);
     }
 #endif
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::adjacent_find", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         auto iequal = adjacent_find(std::execution::par, data_int.begin(), data_int.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         if (iequal == data_int.end()) printf("No equal pairs found\n");
         print_results("Parallel std::adjacent_find", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::adjacent_find", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         auto iequal = adjacent_find(std::execution::par_unseq, data_int.begin(), data_int.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         if (iequal == data_int.end()) printf("No equal pairs found\n");
         print_results("Parallel SIMD std::adjacent_find", data_int, startTime, endTime);
     }
+
+    // Search of early_exit_search.h, which stops the workers searching after the first equal pair once it is found
+
+    for (size_t i = 0; next_iteration("Parallel early exit adjacent_find", i, num_times); i++)
+    {
+        startTime = start_timer();
+        size_t pair = parallel_early_exit_adjacent_find(data_int.data(), data_int.size());
+        endTime = stop_timer();
+        if (pair == array_size) printf("No equal pairs found\n");
+        print_results("Parallel early exit adjacent_find", data_int, startTime, endTime);
+        if (pair != first_pair)
+            printf("Parallel early exit adjacent_find: found pair at %zu instead of %zu!\n", pair, first_pair);
+    }
     // dpl::adjacent_find benchmarks
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::adjacent_find", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         auto iequal = adjacent_find(oneapi::dpl::execution::seq, data_int.begin(), data_int.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         if (iequal == data_int.end()) printf("No equal pairs found\n");
         print_results("Serial dpl::adjacent_find", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::adjacent_find", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         auto iequal = adjacent_find(oneapi::dpl::execution::unseq, data_int.begin(), data_int.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         if (iequal == data_int.end()) printf("No equal pairs found\n");
         print_results("SIMD dpl::adjacent_find", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::adjacent_find", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         auto iequal = adjacent_find(oneapi::dpl::execution::par, data_int.begin(), data_int.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         if (iequal == data_int.end()) printf("No equal pairs found\n");
         print_results("Parallel dpl::adjacent_find", data_int, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::adjacent_find", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         auto iequal = adjacent_find(oneapi::dpl::execution::par_unseq, data_int.begin(), data_int.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         if (iequal == data_int.end()) printf("No equal pairs found\n");
         print_results("Parallel SIMD dpl::adjacent_find", data_int, startTime, endTime);
     }
@@ -1685,8 +2073,8 @@ void adjacent_find_benchmark(size_t array_size, size_t num_times)
 
 void adjacent_difference_benchmark(size_t array_size, size_t num_times)
 {
-    std::vector<int>       data_int_src(array_size);
-    std::vector<int>       data_int_dst(array_size, 10);
+    bench_vector<int>       data_int_src(array_size);
+    bench_vector<int>       data_int_dst(array_size, 10);
     high_resolution_clock::time_point startTime, endTime;
 
     printf("\nAdjacent Difference\n");
@@ -1702,70 +2090,70 @@ void adjacent_difference_benchmark(size_t array_size, size_t num_times)
     // std::adjacent_difference benchmarks
     printf("Benchmarks:\n");
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::adjacent_difference", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         adjacent_difference(std::execution::seq, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial std::adjacent_difference", data_int_src, startTime, endTime);
     }
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::adjacent_difference", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         adjacent_difference(std::execution::unseq, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial SIMD std::adjacent_difference", data_int_src, startTime, endTime);
     }
 #endif
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::adjacent_difference", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         adjacent_difference(std::execution::par, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel std::adjacent_difference", data_int_src, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::adjacent_difference", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         adjacent_difference(std::execution::par_unseq, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::adjacent_difference", data_int_src, startTime, endTime);
     }
 #if 0
     // dpl::adjacent_difference benchmarks (Intel doesn't implement!)
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::adjacent_difference", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         adjacent_difference(oneapi::dpl::execution::seq, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::adjacent_difference", data_int_src, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::adjacent_difference", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         adjacent_difference(oneapi::dpl::execution::unseq, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::adjacent_difference", data_int_src, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::adjacent_difference", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         adjacent_difference(oneapi::dpl::execution::par, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::adjacent_difference", data_int_src, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::adjacent_difference", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         adjacent_difference(oneapi::dpl::execution::par_unseq, data_int_src.begin(), data_int_src.end(), data_int_dst.begin());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::adjacent_difference", data_int_src, startTime, endTime);
     }
 
@@ -1775,9 +2163,9 @@ void adjacent_difference_benchmark(size_t array_size, size_t num_times)
 
 void max_element_benchmark(size_t array_size, size_t num_times)
 {
-    std::vector<int>       data_int_src(array_size);
+    bench_vector<int>       data_int_src(array_size);
     high_resolution_clock::time_point startTime, endTime;
-    std::vector<int>::iterator max_index;
+    bench_vector<int>::iterator max_index;
 
     printf("\n\n");
 
@@ -1791,70 +2179,91 @@ void max_element_benchmark(size_t array_size, size_t num_times)
 #if 1
     // std::max_element benchmarks
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial std::max_element", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         max_index = max_element(std::execution::seq, data_int_src.begin(), data_int_src.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial std::max_element", max_index, data_int_src, startTime, endTime);
     }
 #ifndef MICROSOFT_ALGORITHMS
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial SIMD std::max_element", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         max_index = max_element(std::execution::unseq, data_int_src.begin(), data_int_src.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial SIMD std::max_element", max_index, data_int_src, startTime, endTime);
     }
 #endif
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel std::max_element", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         max_index = max_element(std::execution::par, data_int_src.begin(), data_int_src.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel std::max_element", max_index, data_int_src, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD std::max_element", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         max_index = max_element(std::execution::par_unseq, data_int_src.begin(), data_int_src.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD std::max_element", max_index, data_int_src, startTime, endTime);
     }
+
+    // Hand-vectorized kernels of simd_reductions.h, the widest the CPU supports, which return the first index of the
+    // maximum (minimum) as std::max_element (std::min_element) does
+
+    const char*      kernel_tags[] = { "Serial SIMD kernel max_element", "Parallel SIMD kernel max_element",
+                                       "Serial SIMD kernel min_element", "Parallel SIMD kernel min_element" };
+    ExtremumFunction kernels[]     = { simd_max_element, parallel_simd_max_element, simd_min_element, parallel_simd_min_element };
+    const auto       std_max_index = max_element(std::execution::par, data_int_src.begin(), data_int_src.end());
+    const auto       std_min_index = min_element(std::execution::par, data_int_src.begin(), data_int_src.end());
+    for (size_t k = 0; k < 4; k++)
+    {
+        for (size_t i = 0; next_iteration(kernel_tags[k], i, num_times); i++)
+        {
+            startTime = start_timer();
+            max_index = data_int_src.begin() + kernels[k](data_int_src.data(), data_int_src.size());
+            endTime = stop_timer();
+            print_results(kernel_tags[k], max_index, data_int_src, startTime, endTime);
+            if (max_index != (k < 2 ? std_max_index : std_min_index))
+                printf("%s: result differs from the standard algorithm!\n", kernel_tags[k]);
+        }
+    }
 #endif
     // dpl::max_element benchmarks
 #ifdef DPL_ALGORITHMS
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Serial dpl::max_element", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         max_index = max_element(oneapi::dpl::execution::seq, data_int_src.begin(), data_int_src.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Serial dpl::max_element", max_index, data_int_src, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("SIMD dpl::max_element", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         max_index = max_element(oneapi::dpl::execution::unseq, data_int_src.begin(), data_int_src.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("SIMD dpl::max_element", max_index, data_int_src, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel dpl::max_element", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         max_index = max_element(oneapi::dpl::execution::par, data_int_src.begin(), data_int_src.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel dpl::max_element", max_index, data_int_src, startTime, endTime);
     }
 
-    for (size_t i = 0; i < num_times; i++)
+    for (size_t i = 0; next_iteration("Parallel SIMD dpl::max_element", i, num_times); i++)
     {
-        startTime = high_resolution_clock::now();
+        startTime = start_timer();
         max_index = max_element(oneapi::dpl::execution::par_unseq, data_int_src.begin(), data_int_src.end());
-        endTime = high_resolution_clock::now();
+        endTime = stop_timer();
         print_results("Parallel SIMD dpl::max_element", max_index, data_int_src, startTime, endTime);
     }
 
@@ -1862,31 +2271,200 @@ void max_element_benchmark(size_t array_size, size_t num_times)
 }
 
 
-int main()
+// STREAM-style baselines of attainable memory bandwidth (https://www.cs.virginia.edu/stream/), with arrays well beyond
+// the last level cache. Bytes moved are counted as STREAM does, without write-allocate traffic.
+void stream_copy_benchmark(size_t array_size, size_t num_times)
+{
+    bench_vector<double> a(array_size, 1.0);
+    bench_vector<double> c(array_size, 0.0);
+    high_resolution_clock::time_point startTime, endTime;
+
+    printf("\n\n");
+
+    for (size_t i = 0; next_iteration("Parallel STREAM copy", i, num_times); i++)
+    {
+        startTime = start_timer();
+        copy(std::execution::par_unseq, a.begin(), a.end(), c.begin());
+        endTime = stop_timer();
+        print_results("Parallel STREAM copy", c, startTime, endTime);
+    }
+}
+
+void stream_scale_benchmark(size_t array_size, size_t num_times)
+{
+    bench_vector<double> b(array_size, 0.0);
+    bench_vector<double> c(array_size, 1.0);
+    const double scalar = 3.0;
+    high_resolution_clock::time_point startTime, endTime;
+
+    printf("\n\n");
+
+    for (size_t i = 0; next_iteration("Parallel STREAM scale", i, num_times); i++)
+    {
+        startTime = start_timer();
+        transform(std::execution::par_unseq, c.begin(), c.end(), b.begin(), [scalar](double x) { return scalar * x; });
+        endTime = stop_timer();
+        print_results("Parallel STREAM scale", b, startTime, endTime);
+    }
+}
+
+void stream_triad_benchmark(size_t array_size, size_t num_times)
+{
+    bench_vector<double> a(array_size, 0.0);
+    bench_vector<double> b(array_size, 1.0);
+    bench_vector<double> c(array_size, 2.0);
+    const double scalar = 3.0;
+    high_resolution_clock::time_point startTime, endTime;
+
+    printf("\n\n");
+
+    for (size_t i = 0; next_iteration("Parallel STREAM triad", i, num_times); i++)
+    {
+        startTime = start_timer();
+        transform(std::execution::par_unseq, b.begin(), b.end(), c.begin(), a.begin(), [scalar](double x, double y) { return x + scalar * y; });
+        endTime = stop_timer();
+        print_results("Parallel STREAM triad", a, startTime, endTime);
+    }
+}
+
+void stream_fill_benchmark(size_t array_size, size_t num_times)
+{
+    bench_vector<int> data(array_size);
+    high_resolution_clock::time_point startTime, endTime;
+
+    printf("\n\n");
+
+    for (size_t i = 0; next_iteration("Serial non-temporal fill_scalar_around_cache", i, num_times); i++)
+    {
+        startTime = start_timer();
+        fill_scalar_around_cache(data, 42);
+        endTime = stop_timer();
+        print_results("Serial non-temporal fill_scalar_around_cache", data, startTime, endTime);
+    }
+}
+
+// Runs run(policy) with seq, unseq, par and adaptive::auto_policy, for the policy indexes of adaptive_benchmark
+template <class Run>
+void run_with_policy(size_t policy, Run run)
+{
+    switch (policy)
+    {
+    case 0:  run(std::execution::seq);   break;
+#ifndef MICROSOFT_ALGORITHMS
+    case 1:  run(std::execution::unseq); break;
+#endif
+    case 2:  run(std::execution::par);   break;
+    default: run(adaptive::auto_policy); break;
+    }
+}
+
+// Times algorithm with each fixed policy and with adaptive::auto_policy, whose first (calibrating) call is untimed.
+// setup runs untimed before every call, for algorithms that change their input
+template <class Run, class Setup>
+void adaptive_rows(const char* algorithm, const bench_vector<int>& data, size_t num_times, Run run, Setup setup)
+{
+    high_resolution_clock::time_point startTime, endTime;
+    const char* prefixes[] = { "Serial ", "Serial SIMD ", "Parallel ", "Adaptive " };
+    for (size_t p = 0; p < 4; p++)
+    {
+#ifdef MICROSOFT_ALGORITHMS
+        if (p == 1)
+            continue;
+#endif
+        std::string tag = prefixes[p] + std::string(algorithm);
+        for (size_t i = 0; next_iteration(tag.c_str(), i, num_times); i++)
+        {
+            if (i == 0 && p == 3)
+            {
+                size_t calibrated = adaptive::calibration_log().size();
+                setup();
+                run_with_policy(p, run);
+                for (size_t c = calibrated; c < adaptive::calibration_log().size(); c++)
+                    printf("Calibrated %s\n", adaptive::calibration_log()[c].c_str());
+            }
+
+            setup();
+            startTime = start_timer();
+            run_with_policy(p, run);
+            endTime = stop_timer();
+            print_results(tag.c_str(), data, startTime, endTime);
+        }
+    }
+}
+
+template <class Run>
+void adaptive_rows(const char* algorithm, const bench_vector<int>& data, size_t num_times, Run run)
+{
+    adaptive_rows(algorithm, data, num_times, run, [] {});
+}
+
+// Algorithms for which the parallel policies lose to serial ones on small arrays, with adaptive::auto_policy next to
+// the fixed policies. Run over a range of sizes, it reports how far the adaptive policy is from the fastest fixed one
+void adaptive_benchmark(size_t array_size, size_t num_times)
+{
+    bench_vector<int> data(array_size);
+    bench_vector<int> data_dst(array_size);
+    bench_vector<int> unsorted(array_size);
+    volatile size_t   sink = 0;
+
+    printf("\n\n");
+
+    for (size_t i = 0; i < array_size; i++)
+        data[i] = (int)i;
+    generate_input(unsorted.data(), array_size, InputDistribution(), 1234);
+
+    // Unqualified calls find the standard algorithm for std::execution policies and the adaptive one for auto_policy
+    adaptive_rows("count",               data, num_times, [&](auto&& policy) { sink = (size_t)count(policy, data.begin(), data.end(), 42); });
+    adaptive_rows("max_element",         data, num_times, [&](auto&& policy) { sink = (size_t)(max_element(policy, data.begin(), data.end()) - data.begin()); });
+    adaptive_rows("adjacent_find",       data, num_times, [&](auto&& policy) { sink = (size_t)(adjacent_find(policy, data.begin(), data.end()) - data.begin()); });
+    adaptive_rows("adjacent_difference", data, num_times, [&](auto&& policy) { adjacent_difference(policy, data.begin(), data.end(), data_dst.begin()); });
+    adaptive_rows("copy",                data, num_times, [&](auto&& policy) { copy(policy, data.begin(), data.end(), data_dst.begin()); });
+    adaptive_rows("min_element",         data, num_times, [&](auto&& policy) { sink = (size_t)(min_element(policy, data.begin(), data.end()) - data.begin()); });
+    adaptive_rows("equal",               data, num_times, [&](auto&& policy) { sink = (size_t)equal(policy, data.begin(), data.end(), data_dst.begin()); });     // data_dst is the copy
+    adaptive_rows("fill",                data, num_times, [&](auto&& policy) { fill(policy, data_dst.begin(), data_dst.end(), 42); });
+    adaptive_rows("sort",                data, num_times, [&](auto&& policy) { sort(policy, data_dst.begin(), data_dst.end()); },
+                  [&] { copy(std::execution::par, unsorted.begin(), unsorted.end(), data_dst.begin()); });
+    if (sink == array_size + 1)
+        printf("\n");      // uses sink
+}
+
+int main(int argc, char* argv[])
 {
-    size_t array_size = 100'000'000;
-    size_t number_of_tests = 5;
-
-    max_element_benchmark(        array_size, number_of_tests);   // for small arrays parallel implementation is much slower than serial
-    adjacent_difference_benchmark(array_size, number_of_tests);   // for small arrays parallel implementation is much slower than serial
-    adjacent_find_benchmark(      array_size, number_of_tests);   // for small arrays parallel implementation is much slower than serial
-    all_of_benchmark(             array_size, number_of_tests);
-    any_of_benchmark(             array_size, number_of_tests);
-    count_benchmark(              array_size, number_of_tests);
-    //count_benchmark(10000, 20);                 // for small arrays parallel implementations are much slower than serial
-    equal_benchmark(              array_size, number_of_tests);
-    copy_benchmark(               array_size, number_of_tests);
-    //copy_benchmark(                   10000, 10);   // for small arrays parallel implementation is much slower than serial
-    fill_benchmark(array_size, number_of_tests);
-    merge_benchmark(              array_size, number_of_tests);
-    inplace_merge_benchmark(      array_size, number_of_tests);
-    //merge_dual_buffer_benchmark(  100000000, 10);
-    //merge_single_buffer_benchmark(    10000, 10);
-    //fill_long_long_benchmark(     100000000, 10);
-    sort_benchmark(               array_size, number_of_tests);
-    //sort_doubles_benchmark(         100000000, 10, true );
-    //sort_doubles_benchmark(       100000000, 10, false);
-    stable_sort_benchmark(        array_size, number_of_tests);
-
-    return 0;
+    // Per element of array_size: working set of each benchmark's timed region, bytes its algorithm reads and bytes it writes.
+    // Sorts are declared as reading and writing the array once, so their bandwidth is an effective bandwidth.
+    register_benchmark("max_element",         max_element_benchmark,          4,  4, 0);    // for small arrays parallel implementation is much slower than serial
+    register_benchmark("adjacent_difference", adjacent_difference_benchmark,  8,  4, 4);    // for small arrays parallel implementation is much slower than serial
+    register_benchmark("adjacent_find",       adjacent_find_benchmark,        4,  4, 0, true, INPUTS_MATCH);    // for small arrays parallel implementation is much slower than serial
+    register_benchmark("all_of",              all_of_benchmark,               4,  4, 0, true, INPUTS_MATCH);
+    register_benchmark("any_of",              any_of_benchmark,               4,  4, 0, true, INPUTS_MATCH);
+    register_benchmark("count",               count_benchmark,                4,  4, 0);    // for small arrays parallel implementations are much slower than serial
+    register_benchmark("equal",               equal_benchmark,                8,  8, 0, true, INPUTS_MATCH);
+    register_benchmark("copy",                copy_benchmark,                 8,  4, 4);    // for small arrays parallel implementation is much slower than serial
+    register_benchmark("copy_follow_up",      copy_follow_up_benchmark,       8,  0, 0, false, INPUTS_FIXED, false);    // times a cache-resident sum after each copy, with the caches it left
+    register_benchmark("fill",                fill_benchmark,                 4,  0, 4);
+    register_benchmark("fill_long_long",      fill_long_long_benchmark,       8,  0, 8, false);
+    register_benchmark("merge",               merge_benchmark,               16,  8, 8, true,  INPUTS_DISTRIBUTION | INPUTS_MERGE_RATIO);
+    register_benchmark("inplace_merge",       inplace_merge_benchmark,       16,  8, 8, true,  INPUTS_DISTRIBUTION | INPUTS_MERGE_RATIO);    // two halves of array_size each, and a temporary buffer
+    register_benchmark("merge_dual_buffer",   merge_dual_buffer_benchmark,   16,  8, 8, false, INPUTS_DISTRIBUTION);
+    register_benchmark("merge_single_buffer", merge_single_buffer_benchmark, 16,  8, 8, false, INPUTS_DISTRIBUTION);
+    register_benchmark("sort",                sort_benchmark,                 4,  4, 4, true,  INPUTS_DISTRIBUTION);
+    register_benchmark("sort_doubles",        [](size_t array_size, size_t num_times) { sort_doubles_benchmark(array_size, num_times, true ); },  8, 8, 8, false, INPUTS_DISTRIBUTION);
+    register_benchmark("sort_doubles_fresh",  [](size_t array_size, size_t num_times) { sort_doubles_benchmark(array_size, num_times, false); },  8, 8, 8, false, INPUTS_DISTRIBUTION);
+    register_benchmark("stable_sort",         stable_sort_benchmark,          8,  4, 4, true,  INPUTS_DISTRIBUTION);    // array and a temporary buffer
+    register_benchmark("stream_copy",         stream_copy_benchmark,         16,  8,  8, false);
+    register_benchmark("stream_scale",        stream_scale_benchmark,        16,  8,  8, false);
+    register_benchmark("stream_triad",        stream_triad_benchmark,        24, 16,  8, false);
+    register_benchmark("stream_fill",         stream_fill_benchmark,          4,  0,  4, false);
+    register_benchmark("adaptive",            adaptive_benchmark,             8,  4,  0, false);    // sizes from --size or --sweep, e.g. --size=1e3..1e8
+
+    if (!parse_command_line(argc, argv))
+        return 1;
+    if (!benchmark_options.compare_baseline.empty())
+        return compare_results_files(benchmark_options.compare_baseline, benchmark_options.compare_current);
+
+    int status = run_benchmarks();
+    if (!write_results_files())
+        status = 1;
+
+    return status;
 }
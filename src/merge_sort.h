@@ -0,0 +1,108 @@
+// Parallel stable merge sort, which takes its scratch buffer from the caller so that repeated sorts allocate nothing.
+//
+// Runs of merge_sort_run elements are insertion sorted, then merged bottom-up, doubling the run width each level and
+// ping-ponging between the array and the scratch buffer. Blocks of merge_sort_block elements, which fit in the L2
+// cache together with their part of the scratch buffer, are first sorted completely, each by one thread. The levels
+// above are merged over the whole array, which is split into equal chunks of output. A chunk may cover many pairs of
+// runs or a part of one pair, located with a merge path search (parallel_merge.h), so every level is parallel.
+// The number of levels is known up front: when it is odd, runs are sorted into the scratch buffer, so that the last
+// level writes into the array and no copy back is needed.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+#include "parallel_merge.h"
+#include "parallel_utils.h"
+
+const size_t merge_sort_run   = 32;
+const size_t merge_sort_block = (size_t)1 << 14;
+
+// Merges the pairs of adjacent runs of width, in outputs [begin, end) of source, into destination
+template <class T>
+void merge_sort_level(const T* source, T* destination, size_t n, size_t width, size_t begin, size_t end)
+{
+    for (size_t pair = begin / (2 * width) * (2 * width); pair < end; pair += 2 * width)
+    {
+        size_t middle = std::min(pair + width,     n);
+        size_t last   = std::min(pair + 2 * width, n);
+        merge_path_range(source + pair, middle - pair, source + middle, last - middle, destination + pair,
+                         std::max(begin, pair) - pair, std::min(end, last) - pair);
+    }
+}
+
+// Sorts [first, last) in ascending order, keeping the order of equal elements. scratch, when given, must hold
+// last - first elements; otherwise one is allocated
+template <class T>
+void parallel_merge_sort(T* first, T* last, T* scratch = nullptr)
+{
+    const size_t n = (size_t)(last - first);
+    auto insertion_sort = [](T* begin, T* end)
+    {
+        for (T* i = begin + 1; i < end; i++)
+        {
+            T  value = *i;
+            T* j     = i;
+            for (; j > begin && value < *(j - 1); j--)
+                *j = *(j - 1);
+            *j = value;
+        }
+    };
+    if (n <= merge_sort_run)
+    {
+        insertion_sort(first, last);
+        return;
+    }
+    std::unique_ptr<T[]> allocated;
+    if (scratch == nullptr)
+    {
+        allocated.reset(new T[n]);
+        scratch = allocated.get();
+    }
+
+    size_t levels = 0;
+    for (size_t width = merge_sort_run; width < n; width *= 2)
+        levels++;
+    T* runs = levels % 2 ? scratch : first;      // where the sorted runs go, so the last level ends in first
+    T* other = levels % 2 ? first : scratch;
+
+    // Each block sorted by one thread, in cache
+    const size_t block_width = std::min(merge_sort_block, n);
+    size_t       width       = merge_sort_run;
+    const size_t blocks      = (n + merge_sort_block - 1) / merge_sort_block;
+    parallel_for_chunks(blocks, [&](size_t b)
+    {
+        size_t begin = b * merge_sort_block, end = std::min(begin + merge_sort_block, n);
+        for (size_t run = begin; run < end; run += merge_sort_run)
+        {
+            size_t run_end = std::min(run + merge_sort_run, end);
+            if (runs != first)
+                std::copy(first + run, first + run_end, runs + run);
+            insertion_sort(runs + run, runs + run_end);
+        }
+        T* source = runs;
+        T* destination = other;
+        for (size_t w = merge_sort_run; w < block_width; w *= 2)
+        {
+            merge_sort_level(source, destination, n, w, begin, end);
+            std::swap(source, destination);
+        }
+    });
+    T* source      = runs;
+    T* destination = other;
+    for (; width < block_width; width *= 2)
+        std::swap(source, destination);
+
+    // Levels above the blocks, over the whole array
+    const size_t chunks = parallel_chunk_count(n, (size_t)1 << 16);
+    for (; width < n; width *= 2)
+    {
+        parallel_for_chunks(chunks, [&](size_t c)
+        {
+            auto bounds = chunk_bounds(n, chunks, c);
+            merge_sort_level(source, destination, n, width, bounds.first, bounds.second);
+        });
+        std::swap(source, destination);
+    }
+}
@@ -0,0 +1,121 @@
+// Merge path parallel merge (Odeh, Green, Mwassi, Shmueli, Birk: "Merge Path - Parallel Merging Made Simple").
+// The output of merging a and b is split into equal chunks. The elements of a and b that land in the first k outputs
+// are found by a binary search along the k-th cross diagonal of the merge matrix, so every chunk is merged
+// independently with std::merge, without locks, and the work is split evenly whatever the data.
+// Ties are taken from a first, as std::merge does, so the merge is stable.
+//
+// With non-temporal stores (streaming_stores.h), each chunk merges a few kilobytes at a time into a staging buffer that
+// stays in the L1 cache, and streams it to the full 64-byte lines of its output. The partial lines at the ends of a
+// chunk are written with regular stores, so neighboring chunks never stream to the same line. As with the copy,
+// STORES_AUTO streams only when the inputs and the output together exceed the last level cache.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include <type_traits>
+
+#include "parallel_utils.h"
+#include "streaming_stores.h"
+
+const size_t merge_staging_bytes = 8 * 1024;
+
+// Number of elements of a among the first diagonal elements of the stable merge of a and b
+template <class T>
+size_t merge_path_split(const T* a, size_t a_size, const T* b, size_t b_size, size_t diagonal)
+{
+    size_t low  = diagonal > b_size ? diagonal - b_size : 0;
+    size_t high = std::min(diagonal, a_size);
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (b[diagonal - middle - 1] < a[middle])
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    return low;
+}
+
+// Merges outputs [begin, end) of the stable merge of a and b into out + begin
+template <class T>
+void merge_path_range(const T* a, size_t a_size, const T* b, size_t b_size, T* out, size_t begin, size_t end)
+{
+    size_t a_begin = merge_path_split(a, a_size, b, b_size, begin);
+    size_t a_end   = merge_path_split(a, a_size, b, b_size, end);
+    std::merge(a + a_begin, a + a_end, b + (begin - a_begin), b + (end - a_end), out + begin);
+}
+
+// Merges [a, a_end) and [b, b_end) into count outputs, advancing a and b past the elements taken. The inputs must hold
+// at least count elements together
+template <class T>
+void merge_count(const T*& a, const T* a_end, const T*& b, const T* b_end, T* out, size_t count)
+{
+    T* out_end = out + count;
+    while (out < out_end && a < a_end && b < b_end)
+    {
+        bool from_b = *b < *a;
+        *out++ = from_b ? *b : *a;
+        b += from_b;
+        a += !from_b;
+    }
+    while (out < out_end && a < a_end)
+        *out++ = *a++;
+    while (out < out_end && b < b_end)
+        *out++ = *b++;
+}
+
+// merge_path_range writing the full cache lines of its outputs with streaming stores, through a staging buffer
+template <class T>
+void merge_path_range_streaming(const T* a, size_t a_size, const T* b, size_t b_size, T* out, size_t begin, size_t end, CopyLinesFunction copy_lines)
+{
+    const size_t line_elements    = streaming_line_bytes / sizeof(T);
+    const size_t staging_elements = merge_staging_bytes / sizeof(T);
+    alignas(64) T staging[merge_staging_bytes / sizeof(T)];
+
+    size_t   a_begin = merge_path_split(a, a_size, b, b_size, begin);
+    size_t   a_end   = merge_path_split(a, a_size, b, b_size, end);
+    const T* from_a  = a + a_begin;
+    const T* from_b  = b + (begin - a_begin);
+    const T* a_last  = a + a_end;
+    const T* b_last  = b + (end - a_end);
+    T*       to      = out + begin;
+    T*       to_end  = out + end;
+
+    T* aligned = (T*)(((uintptr_t)to + streaming_line_bytes - 1) & ~(uintptr_t)(streaming_line_bytes - 1));
+    aligned    = std::min(aligned, to_end);
+    merge_count(from_a, a_last, from_b, b_last, to, (size_t)(aligned - to));
+    to = aligned;
+    while ((size_t)(to_end - to) >= line_elements)
+    {
+        size_t count = std::min(staging_elements, (size_t)(to_end - to) / line_elements * line_elements);
+        merge_count(from_a, a_last, from_b, b_last, staging, count);
+        copy_lines((char*)to, (const char*)staging, count / line_elements);
+        to += count;
+    }
+    merge_count(from_a, a_last, from_b, b_last, to, (size_t)(to_end - to));
+}
+
+// Merges a and b into out, which must hold a_size + b_size elements and not overlap them. mode selects regular or
+// streaming stores for the output
+template <class T>
+void parallel_merge(const T* a, size_t a_size, const T* b, size_t b_size, T* out, StoreMode mode = STORES_AUTO)
+{
+    static_assert(std::is_trivially_copyable<T>::value && streaming_line_bytes % sizeof(T) == 0, "elements must tile a cache line");
+    const size_t n         = a_size + b_size;
+    const size_t chunks    = parallel_chunk_count(n, (size_t)1 << 16);
+    const bool   streaming = mode == STORES_NONTEMPORAL || (mode == STORES_AUTO && copy_streams(n * sizeof(T)));
+    CopyLinesFunction copy_lines = copy_lines_function<true, true>();
+    parallel_for_chunks(chunks, [&](size_t c)
+    {
+        auto bounds = chunk_bounds(n, chunks, c);
+        if (streaming)
+        {
+            merge_path_range_streaming(a, a_size, b, b_size, out, bounds.first, bounds.second, copy_lines);
+            _mm_sfence();
+        }
+        else
+            merge_path_range(a, a_size, b, b_size, out, bounds.first, bounds.second);
+    });
+}
@@ -0,0 +1,36 @@
+// Building blocks of the parallel algorithms of this repository. A range of n elements is split into a fixed number of
+// contiguous chunks, which std::for_each(std::execution::par) runs on the TBB threads (or those of the library backing
+// the parallel policies), so the thread limit of --threads applies to these algorithms as to the standard ones.
+// A fixed chunk count, rather than the partitioning of the backend, lets per-chunk results such as histograms be
+// combined deterministically.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <execution>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Number of chunks to split n elements into: several per hardware thread for load balance, none smaller than min_chunk
+inline size_t parallel_chunk_count(size_t n, size_t min_chunk)
+{
+    size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+    return std::max(std::min(n / std::max(min_chunk, (size_t)1), 4 * threads), (size_t)1);
+}
+
+// [begin, end) of chunk c of n elements split into chunks
+inline std::pair<size_t, size_t> chunk_bounds(size_t n, size_t chunks, size_t c)
+{
+    return { n / chunks * c + std::min(c, n % chunks), n / chunks * (c + 1) + std::min(c + 1, n % chunks) };
+}
+
+// Runs function(c) for every chunk c in parallel
+template <class Function>
+void parallel_for_chunks(size_t chunks, Function function)
+{
+    std::vector<size_t> indexes(chunks);
+    std::iota(indexes.begin(), indexes.end(), (size_t)0);
+    std::for_each(std::execution::par, indexes.begin(), indexes.end(), function);
+}
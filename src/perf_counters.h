@@ -0,0 +1,187 @@
+// Hardware performance counters of the timed region of a benchmark, read with Linux perf_event_open.
+//
+// Counters are opened for every thread of the process (the main thread and the TBB worker threads), so the values are
+// summed over all threads that run the algorithm. Threads created since the last measurement get counters at the next
+// start(). Each event is opened on its own, so events the CPU or the kernel does not support (common in containers and
+// virtual machines) are reported as unavailable while the others are still counted. When counting is multiplexed, the
+// values are scaled by the time each counter was enabled versus running. On other operating systems nothing is counted.
+#pragma once
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum PerfEvent
+{
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_LLC_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_STALLED_CYCLES,
+    PERF_EVENT_COUNT
+};
+
+inline const char* perf_event_name(int event)
+{
+    static const char* names[PERF_EVENT_COUNT] = { "cycles", "instructions", "llc_misses", "dtlb_misses", "branch_misses", "stalled_cycles" };
+    return names[event];
+}
+
+struct PerfCounterValues
+{
+    double values[PERF_EVENT_COUNT] = {};
+    bool   valid[PERF_EVENT_COUNT]  = {};
+};
+
+class PerfCounters
+{
+public:
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (auto& thread : threads_)
+            for (int fd : thread.fds)
+                if (fd >= 0)
+                    close(fd);
+#endif
+    }
+
+    // Opens counters for threads that do not have them yet. Returns false when no counter could be opened
+    bool open()
+    {
+#ifdef __linux__
+        DIR* tasks = opendir("/proc/self/task");
+        if (tasks == nullptr)
+            return false;
+        while (dirent* task = readdir(tasks))
+        {
+            if (task->d_name[0] == '.')
+                continue;
+            pid_t tid = (pid_t)atoi(task->d_name);
+            bool known = false;
+            for (auto& thread : threads_)
+                known = known || thread.tid == tid;
+            if (!known)
+                open_thread(tid);
+        }
+        closedir(tasks);
+        for (bool supported : supported_)
+            if (supported)
+                return true;
+        return false;
+#else
+        return false;
+#endif
+    }
+
+    bool supported(int event) const { return supported_[event]; }
+    const std::string& error() const { return error_; }
+
+    void start()
+    {
+#ifdef __linux__
+        for (auto& thread : threads_)
+        {
+            for (int fd : thread.fds)
+            {
+                if (fd < 0)
+                    continue;
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    PerfCounterValues stop()
+    {
+        PerfCounterValues sum;
+#ifdef __linux__
+        for (auto& thread : threads_)
+            for (int fd : thread.fds)
+                if (fd >= 0)
+                    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+        for (auto& thread : threads_)
+        {
+            for (int event = 0; event < PERF_EVENT_COUNT; event++)
+            {
+                int fd = thread.fds[event];
+                if (fd < 0)
+                    continue;
+                unsigned long long data[3];     // value, time enabled, time running
+                if (read(fd, data, sizeof(data)) != (ssize_t)sizeof(data))
+                    continue;
+                double value = (double)data[0];
+                if (data[2] > 0 && data[2] < data[1])
+                    value *= (double)data[1] / (double)data[2];
+                sum.values[event] += value;
+                sum.valid[event]   = true;
+            }
+        }
+#endif
+        return sum;
+    }
+
+private:
+#ifdef __linux__
+    struct ThreadCounters
+    {
+        pid_t            tid;
+        std::vector<int> fds;       // one per PerfEvent, -1 when not available
+    };
+
+    void open_thread(pid_t tid)
+    {
+        static const unsigned int types[PERF_EVENT_COUNT] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE };
+        static const unsigned long long configs[PERF_EVENT_COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+            PERF_COUNT_HW_BRANCH_MISSES,
+            PERF_COUNT_HW_STALLED_CYCLES_BACKEND };
+
+        ThreadCounters thread{ tid, std::vector<int>(PERF_EVENT_COUNT, -1) };
+        for (int event = 0; event < PERF_EVENT_COUNT; event++)
+        {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size           = sizeof(attr);
+            attr.type           = types[event];
+            attr.config         = configs[event];
+            attr.disabled       = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            int fd = (int)syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0);
+            if (fd < 0)
+            {
+                if (error_.empty())
+                    error_ = std::string(perf_event_name(event)) + ": " + strerror(errno);
+                continue;
+            }
+            thread.fds[event]  = fd;
+            supported_[event]  = true;
+        }
+        threads_.push_back(thread);
+    }
+
+    std::vector<ThreadCounters> threads_;
+#endif
+    bool        supported_[PERF_EVENT_COUNT] = {};
+    std::string error_;
+};
@@ -0,0 +1,139 @@
+// Parallel LSD (least significant digit first) radix sort of 32 and 64-bit keys: int, unsigned, long long,
+// unsigned long long, float and double.
+//
+// Keys are mapped to unsigned integers that order the same way: the sign bit of signed integers is flipped, and for
+// floating point the sign bit is flipped for positive values and all bits for negative ones. The resulting order is
+// total: -NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < +NaN, with NaNs ordered by their payload.
+//
+// Each pass sorts by one 8-bit digit, from the least significant one. The chunks of the array count their digits in
+// parallel, into a histogram per chunk, and passes where all keys share the digit are skipped. An exclusive prefix of
+// the counts (over digits, then over chunks, in parallel per digit) gives each chunk its own output position for every
+// digit, and the chunks scatter in parallel. Each chunk collects elements per digit in cache-line sized write-combining
+// buffers and writes full lines, instead of one element at a time into 256 places. Sorting ping-pongs between the array
+// and a scratch buffer of the same size, which the caller may pass in. When an odd number of passes ran, the result is
+// copied back.
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include "parallel_utils.h"
+
+// Unsigned key of a value, ordered like the values
+template <class T>
+struct RadixKey
+{
+    static_assert((sizeof(T) == 4 || sizeof(T) == 8) && std::is_arithmetic<T>::value, "radix sort supports 32 and 64-bit keys");
+    typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type Unsigned;
+
+    static Unsigned of(T value)
+    {
+        const Unsigned sign = (Unsigned)1 << (8 * sizeof(T) - 1);
+        Unsigned bits;
+        memcpy(&bits, &value, sizeof(T));
+        if (std::is_floating_point<T>::value)
+            return (bits & sign) ? ~bits : (bits | sign);
+        if (std::is_signed<T>::value)
+            return bits ^ sign;
+        return bits;
+    }
+};
+
+const int    radix_digit_bits = 8;
+const size_t radix_buckets    = (size_t)1 << radix_digit_bits;
+
+// Sorts [first, last) in ascending order. scratch, when given, must hold last - first elements; otherwise one is allocated
+template <class T>
+void parallel_radix_sort(T* first, T* last, T* scratch = nullptr)
+{
+    const int    passes = (int)sizeof(T);
+    const size_t n      = (size_t)(last - first);
+    if (n < radix_buckets)
+    {
+        std::sort(first, last, [](T a, T b) { return RadixKey<T>::of(a) < RadixKey<T>::of(b); });
+        return;
+    }
+    std::unique_ptr<T[]> allocated;
+    if (scratch == nullptr)
+    {
+        allocated.reset(new T[n]);
+        scratch = allocated.get();
+    }
+
+    T* source      = first;
+    T* destination = scratch;
+    const size_t chunks = parallel_chunk_count(n, (size_t)1 << 16);
+    std::vector<size_t> counts(chunks * radix_buckets);     // counts[chunk * radix_buckets + digit], then output offsets
+    std::vector<size_t> digits(radix_buckets);
+    std::iota(digits.begin(), digits.end(), (size_t)0);
+
+    for (int pass = 0; pass < passes; pass++)
+    {
+        const int shift = pass * radix_digit_bits;
+        parallel_for_chunks(chunks, [&](size_t c)
+        {
+            auto    bounds = chunk_bounds(n, chunks, c);
+            size_t* count  = &counts[c * radix_buckets];
+            std::fill(count, count + radix_buckets, (size_t)0);
+            for (size_t i = bounds.first; i < bounds.second; i++)
+                count[(RadixKey<T>::of(source[i]) >> shift) & (radix_buckets - 1)]++;
+        });
+
+        size_t totals[radix_buckets] = {};
+        for (size_t c = 0; c < chunks; c++)
+            for (size_t d = 0; d < radix_buckets; d++)
+                totals[d] += counts[c * radix_buckets + d];
+        if (std::find(totals, totals + radix_buckets, n) != totals + radix_buckets)
+            continue;       // every key has the same digit
+
+        size_t starts[radix_buckets];
+        for (size_t d = 0, start = 0; d < radix_buckets; d++)
+        {
+            starts[d] = start;
+            start    += totals[d];
+        }
+        std::for_each(std::execution::par, digits.begin(), digits.end(), [&](size_t d)
+        {
+            size_t offset = starts[d];
+            for (size_t c = 0; c < chunks; c++)
+            {
+                size_t& count = counts[c * radix_buckets + d];
+                size_t  here  = count;
+                count   = offset;
+                offset += here;
+            }
+        });
+
+        parallel_for_chunks(chunks, [&](size_t c)
+        {
+            const size_t  line = 64 / sizeof(T);        // elements per cache line
+            alignas(64) T buffers[radix_buckets][64 / sizeof(T)];
+            unsigned char filled[radix_buckets] = {};
+            size_t*       offsets = &counts[c * radix_buckets];
+            auto          bounds  = chunk_bounds(n, chunks, c);
+            for (size_t i = bounds.first; i < bounds.second; i++)
+            {
+                T      value = source[i];
+                size_t digit = (RadixKey<T>::of(value) >> shift) & (radix_buckets - 1);
+                buffers[digit][filled[digit]++] = value;
+                if (filled[digit] == line)
+                {
+                    memcpy(destination + offsets[digit], buffers[digit], line * sizeof(T));
+                    offsets[digit] += line;
+                    filled[digit]   = 0;
+                }
+            }
+            for (size_t d = 0; d < radix_buckets; d++)
+                memcpy(destination + offsets[d], buffers[d], filled[d] * sizeof(T));
+        });
+        std::swap(source, destination);
+    }
+    if (source != first)
+        std::copy(std::execution::par, source, source + n, first);
+}
@@ -0,0 +1,407 @@
+// Compare mode: loads two results files written with --json or --csv, a baseline and a current run, pairs up results
+// of the same benchmark, tag (algorithm and policy), size, thread count and buffer placement (page-in, pages and NUMA
+// policy), and tests whether their samples differ with the two-sided Mann-Whitney U test. A pair whose median changed by
+// more than the threshold with a p-value below alpha is a regression (slower) or an improvement (faster). Any regression
+// makes the program exit with 1.
+//     benchmark_parallel_std --compare=gcc12.json,gcc13.json --threshold=5 --alpha=0.05
+#pragma once
+
+#include <cctype>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark_harness.h"
+
+// Minimal JSON reader for results files: objects, arrays, strings, numbers, true, false and null
+struct JsonValue
+{
+    enum Type { null_value, boolean, number, string, array, object } type = null_value;
+    double                                         number_value = 0.0;
+    std::string                                    string_value;
+    std::vector<JsonValue>                         items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* find(const std::string& name) const
+    {
+        for (auto& member : members)
+            if (member.first == name)
+                return &member.second;
+        return nullptr;
+    }
+};
+
+class JsonReader
+{
+public:
+    explicit JsonReader(const std::string& text) : text_(text) {}
+
+    bool parse(JsonValue& value)
+    {
+        return parse_value(value) && (skip_space(), position_ == text_.size());
+    }
+
+private:
+    void skip_space()
+    {
+        while (position_ < text_.size() && isspace((unsigned char)text_[position_]))
+            position_++;
+    }
+
+    bool parse_value(JsonValue& value)
+    {
+        skip_space();
+        if (position_ >= text_.size())
+            return false;
+        char c = text_[position_];
+        if (c == '{') return parse_object(value);
+        if (c == '[') return parse_array(value);
+        if (c == '"') { value.type = JsonValue::string; return parse_string(value.string_value); }
+        if (text_.compare(position_, 4, "true")  == 0) { value.type = JsonValue::boolean; value.number_value = 1.0; position_ += 4; return true; }
+        if (text_.compare(position_, 5, "false") == 0) { value.type = JsonValue::boolean; position_ += 5; return true; }
+        if (text_.compare(position_, 4, "null")  == 0) { value.type = JsonValue::null_value; position_ += 4; return true; }
+
+        const char* start = text_.c_str() + position_;
+        char*       end   = nullptr;
+        value.type         = JsonValue::number;
+        value.number_value = strtod(start, &end);
+        position_ += (size_t)(end - start);
+        return end != start;
+    }
+
+    bool parse_string(std::string& result)
+    {
+        position_++;    // opening quote
+        while (position_ < text_.size() && text_[position_] != '"')
+        {
+            char c = text_[position_++];
+            if (c != '\\')
+            {
+                result += c;
+                continue;
+            }
+            if (position_ >= text_.size())
+                return false;
+            char escaped = text_[position_++];
+            switch (escaped)
+            {
+            case 'n': result += '\n'; break;
+            case 't': result += '\t'; break;
+            case 'r': result += '\r'; break;
+            case 'b': result += '\b'; break;
+            case 'f': result += '\f'; break;
+            case 'u':
+                if (position_ + 4 > text_.size())
+                    return false;
+                result += (char)strtol(text_.substr(position_, 4).c_str(), nullptr, 16);   // results files escape only control characters
+                position_ += 4;
+                break;
+            default:  result += escaped;
+            }
+        }
+        if (position_ >= text_.size())
+            return false;
+        position_++;    // closing quote
+        return true;
+    }
+
+    bool parse_array(JsonValue& value)
+    {
+        value.type = JsonValue::array;
+        position_++;
+        skip_space();
+        if (position_ < text_.size() && text_[position_] == ']')
+            return ++position_, true;
+        while (true)
+        {
+            JsonValue item;
+            if (!parse_value(item))
+                return false;
+            value.items.push_back(item);
+            skip_space();
+            if (position_ >= text_.size())
+                return false;
+            if (text_[position_++] == ']')
+                return true;
+            if (text_[position_ - 1] != ',')
+                return false;
+        }
+    }
+
+    bool parse_object(JsonValue& value)
+    {
+        value.type = JsonValue::object;
+        position_++;
+        skip_space();
+        if (position_ < text_.size() && text_[position_] == '}')
+            return ++position_, true;
+        while (true)
+        {
+            std::string name;
+            JsonValue   member;
+            skip_space();
+            if (position_ >= text_.size() || text_[position_] != '"' || !parse_string(name))
+                return false;
+            skip_space();
+            if (position_ >= text_.size() || text_[position_++] != ':' || !parse_value(member))
+                return false;
+            value.members.push_back({ name, member });
+            skip_space();
+            if (position_ >= text_.size())
+                return false;
+            if (text_[position_++] == '}')
+                return true;
+            if (text_[position_ - 1] != ',')
+                return false;
+        }
+    }
+
+    const std::string& text_;
+    size_t             position_ = 0;
+};
+
+inline bool load_json_results(const std::string& text, std::vector<BenchmarkResult>& results)
+{
+    JsonValue root;
+    if (!JsonReader(text).parse(root) || root.find("results") == nullptr)
+        return false;
+
+    auto text_of   = [](const JsonValue& object, const char* name) { const JsonValue* v = object.find(name); return v ? v->string_value : std::string(); };
+    auto number_of = [](const JsonValue& object, const char* name) { const JsonValue* v = object.find(name); return v ? v->number_value : 0.0; };
+
+    for (auto& item : root.find("results")->items)
+    {
+        BenchmarkResult result;
+        result.benchmark    = text_of(item, "benchmark");
+        result.tag          = text_of(item, "tag");
+        result.policy       = text_of(item, "policy");
+        result.element_type = text_of(item, "element_type");
+        result.cache_level  = text_of(item, "cache_level");
+        result.array_size   = (size_t)number_of(item, "size");
+        result.threads      = (size_t)number_of(item, "threads");
+        result.page_in      = text_of(item, "page_in");
+        result.pages        = text_of(item, "pages");
+        result.numa         = text_of(item, "numa");
+        result.cache        = text_of(item, "cache");
+        result.match        = text_of(item, "match");
+        result.distribution = text_of(item, "distribution");
+        result.merge_ratio  = text_of(item, "merge_ratio");
+        result.working_set  = (size_t)number_of(item, "working_set");
+        result.bytes_moved  = (size_t)number_of(item, "bytes_moved");
+        if (const JsonValue* samples = item.find("samples_ms"))
+            for (auto& sample : samples->items)
+                result.samples.push_back(sample.number_value);
+        result.stats = compute_statistics(result.samples);
+        results.push_back(result);
+    }
+    return true;
+}
+
+// Splits a CSV line into fields, honoring double-quoted fields
+inline std::vector<std::string> split_csv_line(const std::string& line)
+{
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); i++)
+    {
+        char c = line[i];
+        if (quoted && c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+            fields.back() += '"', i++;
+        else if (c == '"')
+            quoted = !quoted;
+        else if (c == ',' && !quoted)
+            fields.emplace_back();
+        else if (c != '\r')
+            fields.back() += c;
+    }
+    return fields;
+}
+
+inline bool load_csv_results(const std::string& text, std::vector<BenchmarkResult>& results)
+{
+    std::map<std::string, size_t> columns;
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos)
+            end = text.size();
+        std::string line = text.substr(start, end - start);
+        start = end + 1;
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::vector<std::string> fields = split_csv_line(line);
+        if (columns.empty())
+        {
+            for (size_t f = 0; f < fields.size(); f++)
+                columns[fields[f]] = f;
+            if (columns.count("tag") == 0 || columns.count("samples_ms") == 0)
+                return false;
+            continue;
+        }
+        auto field = [&](const char* name) { auto c = columns.find(name); return c != columns.end() && c->second < fields.size() ? fields[c->second] : std::string(); };
+
+        BenchmarkResult result;
+        result.benchmark    = field("benchmark");
+        result.tag          = field("tag");
+        result.policy       = field("policy");
+        result.element_type = field("element_type");
+        result.cache_level  = field("cache_level");
+        result.array_size   = (size_t)strtod(field("size").c_str(), nullptr);
+        result.threads      = (size_t)strtod(field("threads").c_str(), nullptr);
+        result.page_in      = field("page_in");
+        result.pages        = field("pages");
+        result.numa         = field("numa");
+        result.cache        = field("cache");
+        result.match        = field("match");
+        result.distribution = field("distribution");
+        result.merge_ratio  = field("merge_ratio");
+        result.working_set  = (size_t)strtod(field("working_set").c_str(), nullptr);
+        result.bytes_moved  = (size_t)strtod(field("bytes_moved").c_str(), nullptr);
+        for (auto& sample : split_list(field("samples_ms"), ';'))
+            result.samples.push_back(strtod(sample.c_str(), nullptr));
+        result.stats = compute_statistics(result.samples);
+        results.push_back(result);
+    }
+    return !columns.empty();
+}
+
+inline bool load_results(const std::string& path, std::vector<BenchmarkResult>& results)
+{
+    std::string text = read_text_file(path);
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos)
+        return false;
+    return text[first] == '{' ? load_json_results(text, results) : load_csv_results(text, results);
+}
+
+// Two-sided p-value of the Mann-Whitney U test that samples a and b come from the same distribution. Uses the exact
+// distribution of U for small samples without ties, and otherwise the normal approximation with tie and continuity
+// corrections.
+inline double mann_whitney_p_value(const std::vector<double>& a, const std::vector<double>& b)
+{
+    size_t n1 = a.size(), n2 = b.size();
+    if (n1 == 0 || n2 == 0)
+        return 1.0;
+
+    // Ranks of the pooled samples, with ties given their average rank
+    std::vector<std::pair<double, int>> pooled;
+    for (double x : a) pooled.push_back({ x, 0 });
+    for (double x : b) pooled.push_back({ x, 1 });
+    std::sort(pooled.begin(), pooled.end());
+    double rank_sum_a = 0.0, tie_correction = 0.0;
+    for (size_t i = 0; i < pooled.size(); )
+    {
+        size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first)
+            j++;
+        double ties         = (double)(j - i);
+        double average_rank = (double)(i + j + 1) / 2.0;
+        for (size_t k = i; k < j; k++)
+            if (pooled[k].second == 0)
+                rank_sum_a += average_rank;
+        tie_correction += ties * ties * ties - ties;
+        i = j;
+    }
+    double u1 = rank_sum_a - (double)n1 * (double)(n1 + 1) / 2.0;
+    double u  = std::min(u1, (double)n1 * (double)n2 - u1);
+
+    if (tie_correction == 0.0 && n1 <= 20 && n2 <= 20)
+    {
+        // Number of arrangements with each U value: counts[m][n][u], built up one element at a time
+        size_t max_u = n1 * n2;
+        std::vector<std::vector<std::vector<double>>> counts(n1 + 1, std::vector<std::vector<double>>(n2 + 1, std::vector<double>(max_u + 1, 0.0)));
+        for (size_t m = 0; m <= n1; m++)
+        {
+            for (size_t n = 0; n <= n2; n++)
+            {
+                if (m == 0 || n == 0)
+                {
+                    counts[m][n][0] = 1.0;
+                    continue;
+                }
+                for (size_t v = 0; v <= m * n; v++)     // largest element from a (adds n to U) or from b
+                    counts[m][n][v] = (v >= n ? counts[m - 1][n][v - n] : 0.0) + (v <= (m * (n - 1)) ? counts[m][n - 1][v] : 0.0);
+            }
+        }
+        double total = 0.0, tail = 0.0;
+        for (size_t v = 0; v <= max_u; v++)
+        {
+            total += counts[n1][n2][v];
+            if ((double)v <= u)
+                tail += counts[n1][n2][v];
+        }
+        return std::min(1.0, 2.0 * tail / total);
+    }
+
+    double n     = (double)(n1 + n2);
+    double mean  = (double)n1 * (double)n2 / 2.0;
+    double sigma = std::sqrt((double)n1 * (double)n2 / 12.0 * ((n + 1.0) - tie_correction / (n * (n - 1.0))));
+    if (sigma == 0.0)
+        return 1.0;
+    double z = (mean - u - 0.5) / sigma;
+    return std::min(1.0, std::erfc(std::max(z, 0.0) / std::sqrt(2.0)));
+}
+
+// Identity of a result across runs
+inline std::string comparison_key(const BenchmarkResult& result)
+{
+    return result.benchmark + "|" + result.tag + "|" + std::to_string(result.array_size) + "|" + std::to_string(result.threads) + "|" +
+           result.page_in + "|" + result.pages + "|" + result.numa + "|" + (result.cache.empty() ? "warm" : result.cache) + "|" +     // files before --cache ran warm
+           (result.match == "none" ? "" : result.match) + "|" +   // and searched arrays with no match,
+           (result.distribution == "uniform" ? "" : result.distribution) + "|" +     // sorted uniform values
+           (result.merge_ratio == "1:1" ? "" : result.merge_ratio);                   // and merged equal halves
+}
+
+// Compares two results files. Returns 1 when any result regressed, 2 when a file could not be loaded, otherwise 0
+inline int compare_results_files(const std::string& baseline_path, const std::string& current_path)
+{
+    std::vector<BenchmarkResult> baseline, current;
+    if (!load_results(baseline_path, baseline))
+    {
+        fprintf(stderr, "Could not load results from %s\n", baseline_path.c_str());
+        return 2;
+    }
+    if (!load_results(current_path, current))
+    {
+        fprintf(stderr, "Could not load results from %s\n", current_path.c_str());
+        return 2;
+    }
+
+    std::map<std::string, const BenchmarkResult*> baseline_by_key;
+    for (auto& result : baseline)
+        baseline_by_key[comparison_key(result)] = &result;
+
+    double threshold = benchmark_options.compare_threshold;
+    double alpha     = benchmark_options.compare_alpha;
+    size_t regressions = 0, improvements = 0, unchanged = 0, unmatched = 0;
+
+    printf("Comparing %s (baseline) with %s: threshold = %.1f%%  alpha = %g\n\n", baseline_path.c_str(), current_path.c_str(), 100.0 * threshold, alpha);
+    printf("%-12s %-44s %12s %8s %14s %14s %9s %9s\n", "Status", "Tag", "Size", "Threads", "Baseline(ms)", "Current(ms)", "Change", "p-value");
+    for (auto& result : current)
+    {
+        auto match = baseline_by_key.find(comparison_key(result));
+        if (match == baseline_by_key.end() || match->second->samples.empty() || result.samples.empty())
+        {
+            unmatched++;
+            continue;
+        }
+        const BenchmarkResult& base = *match->second;
+        double change  = (result.stats.median - base.stats.median) / base.stats.median;
+        double p_value = mann_whitney_p_value(base.samples, result.samples);
+
+        const char* status = "unchanged";
+        if (p_value < alpha && change > threshold)
+            status = "REGRESSION", regressions++;
+        else if (p_value < alpha && change < -threshold)
+            status = "improvement", improvements++;
+        else
+            unchanged++;
+        printf("%-12s %-44s %12zu %8zu %14f %14f %+8.1f%% %9.4f\n", status, result.tag.c_str(), result.array_size, result.threads,
+            base.stats.median, result.stats.median, 100.0 * change, p_value);
+    }
+    printf("\n%zu regressions, %zu improvements, %zu unchanged, %zu without a baseline\n", regressions, improvements, unchanged, unmatched);
+    return regressions > 0 ? 1 : 0;
+}
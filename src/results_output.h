@@ -0,0 +1,251 @@
+// Machine-readable results: every result with its samples and statistics, written as JSON (--json) or CSV (--csv),
+// together with a manifest of the environment the benchmarks ran in (CPU, caches, compiler, library versions and
+// memory settings).
+//
+// JSON:  { "manifest": { "key": "value", ... }, "results": [ { ..., "samples_ms": [ ... ] }, ... ] }
+// CSV:   manifest as leading "# key: value" lines, then a header row and one row per result. Samples are separated by ';'
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark_harness.h"
+#include "cpu_features.h"
+
+#if __has_include(<tbb/version.h>)
+#include <tbb/version.h>
+#endif
+
+typedef std::vector<std::pair<std::string, std::string>> Manifest;
+
+inline std::string compiler_version()
+{
+#if defined(__INTEL_LLVM_COMPILER)
+    return "Intel oneAPI " + std::to_string(__INTEL_LLVM_COMPILER) + " (" __VERSION__ ")";
+#elif defined(__NVCOMPILER)
+    return "NVIDIA HPC " + std::to_string(__NVCOMPILER_MAJOR__) + "." + std::to_string(__NVCOMPILER_MINOR__);
+#elif defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "g++ " __VERSION__;
+#elif defined(_MSC_VER)
+    return "MSVC " + std::to_string(_MSC_FULL_VER);
+#else
+    return "unknown";
+#endif
+}
+
+// Flags are not visible to the program, so the build may pass them: -DBENCHMARK_BUILD_FLAGS="\"-O3 -march=native\"".
+// Otherwise the flags are described by the macros they define.
+inline std::string compiler_flags()
+{
+#ifdef BENCHMARK_BUILD_FLAGS
+    return BENCHMARK_BUILD_FLAGS;
+#else
+    std::string flags;
+#if defined(__OPTIMIZE__)
+    flags += "optimized ";
+#endif
+#if defined(NDEBUG)
+    flags += "NDEBUG ";
+#endif
+#if defined(__AVX512F__)
+    flags += "AVX-512 ";
+#elif defined(__AVX2__)
+    flags += "AVX2 ";
+#elif defined(__AVX__)
+    flags += "AVX ";
+#endif
+    flags += "C++" + std::to_string(__cplusplus / 100 % 100);
+    return flags;
+#endif
+}
+
+inline std::string library_versions()
+{
+    std::string versions;
+#if defined(_GLIBCXX_RELEASE)
+    versions += "libstdc++ " + std::to_string(_GLIBCXX_RELEASE) + " (" + std::to_string(__GLIBCXX__) + ")";
+#elif defined(_LIBCPP_VERSION)
+    versions += "libc++ " + std::to_string(_LIBCPP_VERSION);
+#elif defined(_MSVC_STL_VERSION)
+    versions += "MSVC STL " + std::to_string(_MSVC_STL_VERSION);
+#endif
+#if defined(TBB_VERSION_MAJOR)
+    versions += ", TBB " + std::to_string(TBB_VERSION_MAJOR) + "." + std::to_string(TBB_VERSION_MINOR);
+#endif
+#if defined(ONEDPL_VERSION_MAJOR)
+    versions += ", oneDPL " + std::to_string(ONEDPL_VERSION_MAJOR) + "." + std::to_string(ONEDPL_VERSION_MINOR) + "." + std::to_string(ONEDPL_VERSION_PATCH);
+#endif
+    return versions.empty() ? "unknown" : versions;
+}
+
+inline Manifest environment_manifest()
+{
+    Manifest manifest;
+    char     date[32];
+    time_t   now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    std::string caches;
+    for (auto& cache : cache_levels())
+        caches += (caches.empty() ? "" : ", ") + std::string("L") + std::to_string(cache.level) + " " + cache.type + " " + format_bytes((double)cache.size);
+
+    manifest.push_back({ "date",                   date });
+    manifest.push_back({ "command_line",           benchmark_options.command_line });
+    manifest.push_back({ "cpu_model",              cpu_model() });
+    manifest.push_back({ "cpu_features",           cpu_features_description() });
+    manifest.push_back({ "hardware_threads",       std::to_string(hardware_threads()) });
+    manifest.push_back({ "caches",                 caches.empty() ? "unknown" : caches });
+    manifest.push_back({ "compiler",               compiler_version() });
+    manifest.push_back({ "compiler_flags",         compiler_flags() });
+    manifest.push_back({ "libraries",              library_versions() });
+    manifest.push_back({ "transparent_huge_pages", transparent_huge_pages() });
+    manifest.push_back({ "huge_page_pools",        huge_page_pools() });
+    manifest.push_back({ "numa_nodes",             numa_topology() });
+    manifest.push_back({ "thread_pinning",         pin_mode_name(benchmark_options.pin) });
+    manifest.push_back({ "cpu_frequency_governor", cpu_frequency_governor() });
+    return manifest;
+}
+
+inline std::string json_string(const std::string& text)
+{
+    std::string quoted = "\"";
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '"':  quoted += "\\\""; break;
+        case '\\': quoted += "\\\\"; break;
+        case '\n': quoted += "\\n";  break;
+        case '\t': quoted += "\\t";  break;
+        default:
+            if ((unsigned char)c < 0x20)
+            {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)(unsigned char)c);
+                quoted += escaped;
+            }
+            else
+                quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+inline std::string csv_string(const std::string& text)
+{
+    if (text.find_first_of(",\"\n") == std::string::npos)
+        return text;
+    std::string quoted = "\"";
+    for (char c : text)
+        quoted += c == '"' ? std::string("\"\"") : std::string(1, c);
+    return quoted + "\"";
+}
+
+inline std::string number(double value)
+{
+    char text[32];
+    snprintf(text, sizeof(text), "%.9g", value);
+    return text;
+}
+
+inline bool write_json_results(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr)
+        return false;
+
+    fprintf(file, "{\n  \"manifest\": {\n");
+    Manifest manifest = environment_manifest();
+    for (size_t m = 0; m < manifest.size(); m++)
+        fprintf(file, "    %s: %s%s\n", json_string(manifest[m].first).c_str(), json_string(manifest[m].second).c_str(), m + 1 < manifest.size() ? "," : "");
+    fprintf(file, "  },\n  \"results\": [\n");
+
+    for (size_t r = 0; r < benchmark_results.size(); r++)
+    {
+        const BenchmarkResult&  result = benchmark_results[r];
+        const SampleStatistics& s      = result.stats;
+        fprintf(file, "    {\"benchmark\": %s, \"tag\": %s, \"algorithm\": %s, \"policy\": %s, \"element_type\": %s, \"size\": %zu, \"threads\": %zu, "
+                      "\"page_in\": %s, \"pages\": %s, \"numa\": %s, \"cache\": %s, \"match\": %s, \"distribution\": %s, \"merge_ratio\": %s, "
+                      "\"working_set\": %zu, \"cache_level\": %s, \"bytes_moved\": %zu,\n",
+            json_string(result.benchmark).c_str(), json_string(result.tag).c_str(), json_string(algorithm_of(result.tag)).c_str(),
+            json_string(result.policy).c_str(), json_string(result.element_type).c_str(), result.array_size, result.threads,
+            json_string(result.page_in).c_str(), json_string(result.pages).c_str(), json_string(result.numa).c_str(),
+            json_string(result.cache).c_str(), json_string(result.match).c_str(), json_string(result.distribution).c_str(),
+            json_string(result.merge_ratio).c_str(), result.working_set,
+            json_string(result.cache_level).c_str(), result.bytes_moved);
+        fprintf(file, "     \"stats\": {\"count\": %zu, \"outliers\": %zu, \"min_ms\": %s, \"median_ms\": %s, \"p95_ms\": %s, \"mean_ms\": %s, "
+                      "\"stddev_ms\": %s, \"cv\": %s, \"ci95\": %s},\n",
+            s.count, s.outliers, number(s.min).c_str(), number(s.median).c_str(), number(s.p95).c_str(), number(s.mean).c_str(),
+            number(s.stddev).c_str(), number(s.cv).c_str(), number(s.ci95).c_str());
+
+        std::string counters;
+        for (int event = 0; event < PERF_EVENT_COUNT; event++)
+            if (result.counters.valid[event])
+                counters += (counters.empty() ? "" : ", ") + json_string(perf_event_name(event)) + ": " + number(result.counters.values[event]);
+        if (!counters.empty())
+            fprintf(file, "     \"counters\": {%s},\n", counters.c_str());
+
+        std::string samples;
+        for (double sample : result.samples)
+            samples += (samples.empty() ? "" : ", ") + number(sample);
+        fprintf(file, "     \"samples_ms\": [%s]}%s\n", samples.c_str(), r + 1 < benchmark_results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+inline bool write_csv_results(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr)
+        return false;
+
+    for (auto& item : environment_manifest())
+        fprintf(file, "# %s: %s\n", item.first.c_str(), item.second.c_str());
+
+    fprintf(file, "benchmark,tag,algorithm,policy,element_type,size,threads,page_in,pages,numa,cache,match,distribution,merge_ratio,working_set,cache_level,bytes_moved,"
+                  "count,outliers,min_ms,median_ms,p95_ms,mean_ms,stddev_ms,cv,ci95");
+    for (int event = 0; event < PERF_EVENT_COUNT; event++)
+        fprintf(file, ",%s", perf_event_name(event));
+    fprintf(file, ",samples_ms\n");
+
+    for (auto& result : benchmark_results)
+    {
+        const SampleStatistics& s = result.stats;
+        fprintf(file, "%s,%s,%s,%s,%s,%zu,%zu,%s,%s,%s,%s,%s,%s,%s,%zu,%s,%zu,%zu,%zu,%s,%s,%s,%s,%s,%s,%s",
+            csv_string(result.benchmark).c_str(), csv_string(result.tag).c_str(), csv_string(algorithm_of(result.tag)).c_str(),
+            result.policy.c_str(), csv_string(result.element_type).c_str(), result.array_size, result.threads, result.page_in.c_str(),
+            result.pages.c_str(), result.numa.c_str(), result.cache.c_str(), result.match.c_str(), csv_string(result.distribution).c_str(),
+            result.merge_ratio.c_str(), result.working_set, result.cache_level.c_str(), result.bytes_moved, s.count,
+            s.outliers, number(s.min).c_str(), number(s.median).c_str(), number(s.p95).c_str(), number(s.mean).c_str(),
+            number(s.stddev).c_str(), number(s.cv).c_str(), number(s.ci95).c_str());
+        for (int event = 0; event < PERF_EVENT_COUNT; event++)
+            fprintf(file, ",%s", result.counters.valid[event] ? number(result.counters.values[event]).c_str() : "");
+        std::string samples;
+        for (double sample : result.samples)
+            samples += (samples.empty() ? "" : ";") + number(sample);
+        fprintf(file, ",%s\n", samples.c_str());
+    }
+    return fclose(file) == 0;
+}
+
+// Writes the results files requested on the command line. Returns false when one could not be written
+inline bool write_results_files()
+{
+    bool written = true;
+    if (!benchmark_options.json_path.empty() && !write_json_results(benchmark_options.json_path))
+    {
+        fprintf(stderr, "Could not write %s\n", benchmark_options.json_path.c_str());
+        written = false;
+    }
+    if (!benchmark_options.csv_path.empty() && !write_csv_results(benchmark_options.csv_path))
+    {
+        fprintf(stderr, "Could not write %s\n", benchmark_options.csv_path.c_str());
+        written = false;
+    }
+    return written;
+}
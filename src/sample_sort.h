@@ -0,0 +1,370 @@
+// In-place parallel samplesort, after IPS4o (Axtmann, Witt, Ferizovic, Sanders: "In-place Parallel Super Scalar
+// Samplesort"). Extra memory is a few blocks per bucket and thread, instead of the O(n) temporary buffer of
+// std::sort(std::execution::par) and std::stable_sort.
+//
+// Each level distributes the array into up to 255 buckets and recurses into them:
+//   1. Sampling: splitters are picked from a sorted random sample. Duplicate splitters are removed, and each splitter
+//      gets an equality bucket for the keys equal to it, which needs no further sorting. So many equal keys are fine.
+//   2. Classification: the array is split into one stripe per thread. Each element is classified without branches by
+//      descending an implicit binary search tree of the splitters, and appended to a block-sized buffer of its bucket.
+//      A full buffer is written back to the beginning of the stripe, which is always behind the reading position.
+//   3. Block permutation: every bucket gets a block-aligned region of the array. Full blocks in each region are first
+//      moved in front of the empty ones. Then the threads move blocks to the regions of their buckets, swapping them
+//      with blocks not yet in place, with an atomic write and read pointer per bucket.
+//   4. Cleanup: the partly filled buffers and the parts of blocks that cross bucket boundaries fill the gaps at the
+//      beginning and end of each bucket.
+// Buckets are then sorted in parallel with each other, large ones with parallel levels and the rest with sequential
+// levels of the same algorithm, down to std::sort for small buckets.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "parallel_utils.h"
+
+const size_t sample_sort_base_case      = 4096;             // std::sort below this size
+const size_t sample_sort_parallel_size  = (size_t)1 << 22;  // parallel levels for buckets at least this large
+const size_t sample_sort_max_splitters  = 127;              // at most 255 buckets with the equality buckets
+const size_t sample_sort_oversampling   = 16;               // sample elements per splitter
+const size_t sample_sort_block_bytes    = 2048;
+
+// Branchless classification of elements into buckets: bucket 2i holds the keys between splitters i-1 and i,
+// and bucket 2i+1 the keys equal to splitter i
+template <class T>
+class SampleSortClassifier
+{
+public:
+    // Picks up to wanted splitters from the sample
+    void build(std::vector<T>& sample, size_t wanted)
+    {
+        std::sort(sample.begin(), sample.end());
+        splitters_.clear();
+        for (size_t i = 1; i <= wanted; i++)
+        {
+            const T& splitter = sample[i * sample.size() / (wanted + 1)];
+            if (splitters_.empty() || splitters_.back() < splitter)
+                splitters_.push_back(splitter);
+        }
+        count_      = splitters_.size();
+        log_leaves_ = 0;
+        while (((size_t)1 << log_leaves_) < count_ + 1)
+            log_leaves_++;
+        leaves_ = (size_t)1 << log_leaves_;
+
+        std::vector<T> padded(splitters_);
+        padded.resize(leaves_ - 1, splitters_.back());   // so every leaf of the tree has a splitter
+        tree_.resize(leaves_);
+        if (leaves_ > 1)
+            build_tree(padded, 1, 0, leaves_ - 1);
+        splitters_.push_back(splitters_.back());         // so bucket() may read one past the last splitter
+    }
+
+    size_t buckets() const { return 2 * count_ + 1; }
+
+    size_t bucket(const T& value) const
+    {
+        size_t node = 1;
+        for (size_t level = 0; level < log_leaves_; level++)
+            node = 2 * node + (size_t)(tree_[node] < value);
+        return leaf_bucket(node, value);
+    }
+
+    // Buckets of values[0, batch), descending the tree for all of them at once so their loads overlap
+    static const size_t batch = 8;
+    void buckets_of(const T* values, size_t* buckets) const
+    {
+        size_t nodes[batch];
+        for (size_t i = 0; i < batch; i++)
+            nodes[i] = 1;
+        for (size_t level = 0; level < log_leaves_; level++)
+            for (size_t i = 0; i < batch; i++)
+                nodes[i] = 2 * nodes[i] + (size_t)(tree_[nodes[i]] < values[i]);
+        for (size_t i = 0; i < batch; i++)
+            buckets[i] = leaf_bucket(nodes[i], values[i]);
+    }
+
+private:
+    size_t leaf_bucket(size_t node, const T& value) const
+    {
+        size_t index = std::min(node - leaves_, count_);    // splitters less than value
+        return 2 * index + (size_t)(index < count_ && !(value < splitters_[index]));
+    }
+
+    void build_tree(const std::vector<T>& sorted, size_t node, size_t low, size_t high)
+    {
+        size_t middle = (low + high) / 2;
+        tree_[node] = sorted[middle];
+        if (2 * node < leaves_)
+        {
+            build_tree(sorted, 2 * node,     low,        middle);
+            build_tree(sorted, 2 * node + 1, middle + 1, high);
+        }
+    }
+
+    std::vector<T> tree_;           // implicit binary search tree of the splitters, from index 1
+    std::vector<T> splitters_;
+    size_t         count_      = 0;
+    size_t         leaves_     = 1;
+    size_t         log_leaves_ = 0;
+};
+
+// Runs function(i) for i in [0, count), in parallel or serially
+template <class Function>
+void sample_sort_for(bool parallel, size_t count, Function function)
+{
+    if (!parallel)
+    {
+        for (size_t i = 0; i < count; i++)
+            function(i);
+        return;
+    }
+    parallel_for_chunks(count, function);
+}
+
+// Distributes [first, first + n) into the buckets of the classifier. starts receives the beginning of every bucket,
+// followed by n
+template <class T>
+void sample_sort_partition(T* first, size_t n, bool parallel, SampleSortClassifier<T>& classifier, std::vector<size_t>& starts)
+{
+    const size_t block = std::max(sample_sort_block_bytes / sizeof(T), (size_t)1);
+
+    // Sampling
+    size_t wanted = 1;
+    while (wanted < sample_sort_max_splitters && (wanted + 1) * sample_sort_base_case < n)
+        wanted = 2 * wanted + 1;
+    std::vector<T> sample(std::min(n, (wanted + 1) * sample_sort_oversampling));
+    uint64_t random = 0x9E3779B97F4A7C15ull ^ n;
+    for (auto& s : sample)
+    {
+        random ^= random << 13; random ^= random >> 7; random ^= random << 17;
+        s = first[random % n];
+    }
+    classifier.build(sample, wanted);
+    const size_t buckets = classifier.buckets();
+
+    // Classification of each stripe into block buffers, writing full blocks to the beginning of the stripe
+    const size_t slots   = n / block;      // complete block slots of the array
+    const size_t stripes = parallel ? std::max(std::min((size_t)std::max(std::thread::hardware_concurrency(), 1u), slots), (size_t)1) : 1;
+    auto stripe_first_slot = [&](size_t s) { return slots * s / stripes; };
+
+    std::unique_ptr<T[]>      buffers(new T[stripes * buckets * block]);
+    std::vector<size_t>       filled(stripes * buckets, 0);        // elements in each buffer
+    std::vector<size_t>       block_counts(stripes * buckets, 0);  // full blocks written of each bucket
+    std::vector<size_t>       full_slots(stripes, 0);              // full blocks at the beginning of each stripe
+
+    sample_sort_for(parallel, stripes, [&](size_t s)
+    {
+        size_t  begin  = stripe_first_slot(s) * block;
+        size_t  end    = s + 1 == stripes ? n : stripe_first_slot(s + 1) * block;
+        T*      buffer = &buffers[s * buckets * block];
+        size_t* fill   = &filled[s * buckets];
+        size_t* blocks = &block_counts[s * buckets];
+        size_t  write  = begin;
+        auto    append = [&](const T& value, size_t b)
+        {
+            buffer[b * block + fill[b]++] = value;
+            if (fill[b] == block)
+            {
+                memcpy(first + write, buffer + b * block, block * sizeof(T));
+                write  += block;
+                fill[b] = 0;
+                blocks[b]++;
+            }
+        };
+        const size_t batch = SampleSortClassifier<T>::batch;
+        size_t       i     = begin;
+        for (; i + batch <= end; i += batch)
+        {
+            T      values[batch];
+            size_t classes[batch];
+            std::copy(first + i, first + i + batch, values);    // the buffers may overwrite first[i] when written back
+            classifier.buckets_of(values, classes);
+            for (size_t j = 0; j < batch; j++)
+                append(values[j], classes[j]);
+        }
+        for (; i < end; i++)
+            append(first[i], classifier.bucket(first[i]));
+        full_slots[s] = (write - begin) / block;
+    });
+
+    // Bucket boundaries, and the block-aligned region of each bucket
+    std::vector<size_t> full_blocks(buckets, 0);
+    starts.assign(buckets + 1, 0);
+    for (size_t b = 0; b < buckets; b++)
+    {
+        size_t size = 0;
+        for (size_t s = 0; s < stripes; s++)
+        {
+            full_blocks[b] += block_counts[s * buckets + b];
+            size           += filled[s * buckets + b];
+        }
+        starts[b + 1] = starts[b] + size + full_blocks[b] * block;
+    }
+    auto region_first_slot = [&](size_t b) { return (starts[b] + block - 1) / block; };
+
+    // Full blocks of each region in front of its empty ones
+    auto is_full = [&](size_t slot)
+    {
+        size_t s = stripes - 1;
+        while (s > 0 && stripe_first_slot(s) > slot)
+            s--;
+        return slot < stripe_first_slot(s) + full_slots[s];
+    };
+    std::unique_ptr<std::atomic<uint64_t>[]> pointers(new std::atomic<uint64_t>[buckets]);    // write slot << 32 | read slot
+    std::unique_ptr<std::atomic<int>[]>      reading(new std::atomic<int>[buckets]);
+    sample_sort_for(parallel, buckets, [&](size_t b)
+    {
+        size_t low  = region_first_slot(b);
+        size_t high = region_first_slot(b + 1);
+        size_t full = 0;
+        for (size_t slot = low; slot < high; slot++)
+            full += is_full(slot) ? 1 : 0;
+        size_t empty = low, last = high;
+        while (true)
+        {
+            while (empty < high && is_full(empty))
+                empty++;
+            while (last > low && !is_full(last - 1))
+                last--;
+            if (last == low || empty >= last - 1)
+                break;
+            memcpy(first + empty * block, first + (last - 1) * block, block * sizeof(T));
+            empty++;
+            last--;
+        }
+        pointers[b] = ((uint64_t)low << 32) | (uint64_t)(low + full);
+        reading[b]  = 0;
+    });
+
+    // Block permutation. A block crossing the end of the array goes to the overflow buffer
+    std::unique_ptr<T[]> overflow(new T[block]);
+    std::unique_ptr<T[]> swaps(new T[stripes * 2 * block]);
+    sample_sort_for(parallel, stripes, [&](size_t s)
+    {
+        T* current = &swaps[s * 2 * block];
+        T* other   = current + block;
+        for (size_t offset = 0; offset < buckets; offset++)
+        {
+            size_t source = (s * buckets / stripes + offset) % buckets;
+            while (true)
+            {
+                // Take an unplaced block of the region of source
+                reading[source]++;
+                uint64_t state = pointers[source].load();
+                while ((uint32_t)state > (uint32_t)(state >> 32) && !pointers[source].compare_exchange_weak(state, state - 1))
+                    ;
+                if ((uint32_t)state <= (uint32_t)(state >> 32))
+                {
+                    reading[source]--;
+                    break;
+                }
+                memcpy(current, first + ((uint32_t)state - 1) * block, block * sizeof(T));
+                reading[source]--;
+
+                // Place it, swapping with unplaced blocks, until a block lands in an empty slot
+                while (true)
+                {
+                    size_t   destination = classifier.bucket(current[0]);
+                    uint64_t claimed     = pointers[destination].fetch_add((uint64_t)1 << 32);
+                    size_t   slot        = (size_t)(claimed >> 32);
+                    if (slot < (uint32_t)claimed)
+                    {
+                        memcpy(other, first + slot * block, block * sizeof(T));
+                        memcpy(first + slot * block, current, block * sizeof(T));
+                        std::swap(current, other);
+                        continue;
+                    }
+                    while (reading[destination].load() != 0)
+                        std::this_thread::yield();
+                    if ((slot + 1) * block > n)
+                        memcpy(overflow.get(), current, block * sizeof(T));
+                    else
+                        memcpy(first + slot * block, current, block * sizeof(T));
+                    break;
+                }
+            }
+        }
+    });
+
+    // Cleanup: the parts of full blocks past the end of their bucket are saved, then the buffers and saved parts fill
+    // the gaps at the beginning and end of each bucket
+    std::unique_ptr<T[]> spills(new T[buckets * block]);
+    std::vector<size_t>  spilled(buckets, 0);
+    sample_sort_for(parallel, buckets, [&](size_t b)
+    {
+        size_t placed_end = (region_first_slot(b) + full_blocks[b]) * block;
+        size_t end        = starts[b + 1];
+        if (full_blocks[b] == 0 || placed_end <= end)
+            return;
+        T* spill = &spills[b * block];
+        if (placed_end > n)     // the last block of the last bucket is in the overflow buffer
+        {
+            size_t slot_begin = placed_end - block;
+            memcpy(first + slot_begin, overflow.get(), (n - slot_begin) * sizeof(T));
+            memcpy(spill, overflow.get() + (n - slot_begin), (placed_end - n) * sizeof(T));
+        }
+        else
+            memcpy(spill, first + end, (placed_end - end) * sizeof(T));
+        spilled[b] = placed_end - end;
+    });
+    sample_sort_for(parallel, buckets, [&](size_t b)
+    {
+        size_t start        = starts[b], end = starts[b + 1];
+        size_t placed_begin = std::min(region_first_slot(b) * block, end);
+        size_t placed_end   = std::max(std::min((region_first_slot(b) + full_blocks[b]) * block, end), placed_begin);
+        size_t position     = start;
+        auto   write        = [&](const T* source, size_t count)
+        {
+            while (count > 0)
+            {
+                if (position == placed_begin)
+                    position = placed_end;
+                size_t run = std::min(count, (position < placed_begin ? placed_begin : end) - position);
+                memcpy(first + position, source, run * sizeof(T));
+                position += run;
+                source   += run;
+                count    -= run;
+            }
+        };
+        for (size_t s = 0; s < stripes; s++)
+            write(&buffers[(s * buckets + b) * block], filled[s * buckets + b]);
+        write(&spills[b * block], spilled[b]);
+    });
+}
+
+template <class T>
+void sample_sort_recursive(T* first, size_t n, bool parallel)
+{
+    if (n <= sample_sort_base_case)
+    {
+        std::sort(first, first + n);
+        return;
+    }
+    SampleSortClassifier<T> classifier;
+    std::vector<size_t>     starts;
+    sample_sort_partition(first, n, parallel, classifier, starts);
+
+    size_t buckets = classifier.buckets();
+    sample_sort_for(parallel, buckets, [&](size_t b)
+    {
+        size_t size = starts[b + 1] - starts[b];
+        if (b % 2 == 0 && size > 1)     // odd buckets hold keys equal to a splitter
+            sample_sort_recursive(first + starts[b], size, parallel && size >= sample_sort_parallel_size);
+    });
+}
+
+// Sorts [first, last) in ascending order, in place
+template <class T>
+void parallel_sample_sort(T* first, T* last)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "sample sort moves blocks with memcpy");
+    sample_sort_recursive(first, (size_t)(last - first), true);
+}
@@ -0,0 +1,335 @@
+// Hand-vectorized count, max_element and min_element of 32-bit integers, with 128-bit (SSE4.2), 256-bit (AVX2) and
+// 512-bit (AVX-512F) kernels, the widest cpu_features() reports selected at run time.
+//
+// Each kernel keeps four independent accumulators, so consecutive vectors do not wait on each other. count compares
+// against the value and adds the matches per lane. max_element and min_element keep, per lane, the extremum and the
+// index it was found at: a lane only takes a new index when its element is strictly greater (or smaller), so every lane
+// holds the first index of its extremum, and the lanes are combined by value and then by the smaller index. Indexes
+// are 32-bit lanes, so arrays are processed in blocks of reduction_block elements.
+//
+// The parallel versions split the array into a fixed number of chunks and combine the chunk results in chunk order,
+// the earlier chunk winning ties, so the result does not depend on which thread finished first.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include <vector>
+
+#include "cpu_features.h"
+#include "parallel_utils.h"
+
+const size_t reduction_block = (size_t)1 << 30;
+
+typedef size_t (*CountFunction)(const int32_t* data, size_t n, int32_t value);
+typedef size_t (*ExtremumFunction)(const int32_t* data, size_t n);    // index of the first maximum or minimum
+
+template <bool Maximum>
+inline bool better(int32_t value, int32_t best)
+{
+    return Maximum ? value > best : value < best;
+}
+
+inline size_t count_scalar(const int32_t* data, size_t n, int32_t value)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++)
+        count += data[i] == value;
+    return count;
+}
+
+template <bool Maximum>
+size_t extremum_scalar(const int32_t* data, size_t n)
+{
+    size_t best = 0;
+    for (size_t i = 1; i < n; i++)
+        if (better<Maximum>(data[i], data[best]))
+            best = i;
+    return best;
+}
+
+// First index of the extremum among lanes of values and indexes, or of data[from, n) after them
+template <bool Maximum>
+size_t extremum_of_lanes(const int32_t* values, const int32_t* indexes, size_t lanes, const int32_t* data, size_t from, size_t n)
+{
+    size_t best = (size_t)indexes[0];
+    for (size_t l = 1; l < lanes; l++)
+        if (better<Maximum>(values[l], data[best]) || (values[l] == data[best] && (size_t)indexes[l] < best))
+            best = (size_t)indexes[l];
+    for (size_t i = from; i < n; i++)
+        if (better<Maximum>(data[i], data[best]))
+            best = i;
+    return best;
+}
+
+BENCHMARK_TARGET("sse4.2")
+inline size_t count_128(const int32_t* data, size_t n, int32_t value)
+{
+    const __m128i needle = _mm_set1_epi32(value);
+    __m128i counts[4] = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+        for (size_t k = 0; k < 4; k++)      // a match is -1, so subtracting counts it
+            counts[k] = _mm_sub_epi32(counts[k], _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(data + i + 4 * k)), needle));
+    alignas(16) int32_t lanes[4];
+    _mm_store_si128((__m128i*)lanes, _mm_add_epi32(_mm_add_epi32(counts[0], counts[1]), _mm_add_epi32(counts[2], counts[3])));
+    return (size_t)lanes[0] + (size_t)lanes[1] + (size_t)lanes[2] + (size_t)lanes[3] + count_scalar(data + i, n - i, value);
+}
+
+BENCHMARK_TARGET("avx2")
+inline size_t count_256(const int32_t* data, size_t n, int32_t value)
+{
+    const __m256i needle = _mm256_set1_epi32(value);
+    __m256i counts[4] = { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+        for (size_t k = 0; k < 4; k++)
+            counts[k] = _mm256_sub_epi32(counts[k], _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(data + i + 8 * k)), needle));
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256((__m256i*)lanes, _mm256_add_epi32(_mm256_add_epi32(counts[0], counts[1]), _mm256_add_epi32(counts[2], counts[3])));
+    size_t count = 0;
+    for (int32_t lane : lanes)
+        count += (size_t)lane;
+    return count + count_scalar(data + i, n - i, value);
+}
+
+BENCHMARK_TARGET("avx512f")
+inline size_t count_512(const int32_t* data, size_t n, int32_t value)
+{
+    const __m512i needle = _mm512_set1_epi32(value);
+    const __m512i one    = _mm512_set1_epi32(1);
+    __m512i counts[4] = { _mm512_setzero_si512(), _mm512_setzero_si512(), _mm512_setzero_si512(), _mm512_setzero_si512() };
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64)
+        for (size_t k = 0; k < 4; k++)
+            counts[k] = _mm512_mask_add_epi32(counts[k], _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(data + i + 16 * k), needle), counts[k], one);
+    alignas(64) int32_t lanes[16];
+    _mm512_store_si512(lanes, _mm512_add_epi32(_mm512_add_epi32(counts[0], counts[1]), _mm512_add_epi32(counts[2], counts[3])));
+    size_t count = 0;
+    for (int32_t lane : lanes)
+        count += (size_t)lane;
+    return count + count_scalar(data + i, n - i, value);
+}
+
+template <bool Maximum>
+BENCHMARK_TARGET("sse4.2")
+size_t extremum_128(const int32_t* data, size_t n)
+{
+    if (n < 16)
+        return extremum_scalar<Maximum>(data, n);
+    const __m128i step = _mm_set1_epi32(16);
+    __m128i best[4], index[4], current[4];
+    for (size_t k = 0; k < 4; k++)
+    {
+        best[k]    = _mm_loadu_si128((const __m128i*)(data + 4 * k));
+        index[k]   = _mm_setr_epi32((int)(4 * k), (int)(4 * k + 1), (int)(4 * k + 2), (int)(4 * k + 3));
+        current[k] = index[k];
+    }
+    size_t i = 16;
+    for (; i + 16 <= n; i += 16)
+    {
+        for (size_t k = 0; k < 4; k++)
+        {
+            __m128i values = _mm_loadu_si128((const __m128i*)(data + i + 4 * k));
+            __m128i taken  = Maximum ? _mm_cmpgt_epi32(values, best[k]) : _mm_cmpgt_epi32(best[k], values);
+            current[k] = _mm_add_epi32(current[k], step);
+            best[k]    = Maximum ? _mm_max_epi32(best[k], values) : _mm_min_epi32(best[k], values);
+            index[k]   = _mm_blendv_epi8(index[k], current[k], taken);
+        }
+    }
+    alignas(16) int32_t values[16], indexes[16];
+    for (size_t k = 0; k < 4; k++)
+    {
+        _mm_store_si128((__m128i*)(values  + 4 * k), best[k]);
+        _mm_store_si128((__m128i*)(indexes + 4 * k), index[k]);
+    }
+    return extremum_of_lanes<Maximum>(values, indexes, 16, data, i, n);
+}
+
+template <bool Maximum>
+BENCHMARK_TARGET("avx2")
+size_t extremum_256(const int32_t* data, size_t n)
+{
+    if (n < 32)
+        return extremum_scalar<Maximum>(data, n);
+    const __m256i step  = _mm256_set1_epi32(32);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i best[4], index[4], current[4];
+    for (size_t k = 0; k < 4; k++)
+    {
+        best[k]    = _mm256_loadu_si256((const __m256i*)(data + 8 * k));
+        index[k]   = _mm256_add_epi32(lanes, _mm256_set1_epi32((int)(8 * k)));
+        current[k] = index[k];
+    }
+    size_t i = 32;
+    for (; i + 32 <= n; i += 32)
+    {
+        for (size_t k = 0; k < 4; k++)
+        {
+            __m256i values = _mm256_loadu_si256((const __m256i*)(data + i + 8 * k));
+            __m256i taken  = Maximum ? _mm256_cmpgt_epi32(values, best[k]) : _mm256_cmpgt_epi32(best[k], values);
+            current[k] = _mm256_add_epi32(current[k], step);
+            best[k]    = Maximum ? _mm256_max_epi32(best[k], values) : _mm256_min_epi32(best[k], values);
+            index[k]   = _mm256_blendv_epi8(index[k], current[k], taken);
+        }
+    }
+    alignas(32) int32_t values[32], indexes[32];
+    for (size_t k = 0; k < 4; k++)
+    {
+        _mm256_store_si256((__m256i*)(values  + 8 * k), best[k]);
+        _mm256_store_si256((__m256i*)(indexes + 8 * k), index[k]);
+    }
+    return extremum_of_lanes<Maximum>(values, indexes, 32, data, i, n);
+}
+
+template <bool Maximum>
+BENCHMARK_TARGET("avx512f")
+size_t extremum_512(const int32_t* data, size_t n)
+{
+    if (n < 64)
+        return extremum_scalar<Maximum>(data, n);
+    const __m512i step  = _mm512_set1_epi32(64);
+    const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m512i best[4], index[4], current[4];
+    for (size_t k = 0; k < 4; k++)
+    {
+        best[k]    = _mm512_loadu_si512(data + 16 * k);
+        index[k]   = _mm512_add_epi32(lanes, _mm512_set1_epi32((int)(16 * k)));
+        current[k] = index[k];
+    }
+    size_t i = 64;
+    for (; i + 64 <= n; i += 64)
+    {
+        for (size_t k = 0; k < 4; k++)
+        {
+            __m512i   values = _mm512_loadu_si512(data + i + 16 * k);
+            __mmask16 taken  = Maximum ? _mm512_cmpgt_epi32_mask(values, best[k]) : _mm512_cmplt_epi32_mask(values, best[k]);
+            current[k] = _mm512_add_epi32(current[k], step);
+            best[k]    = _mm512_mask_mov_epi32(best[k],  taken, values);
+            index[k]   = _mm512_mask_mov_epi32(index[k], taken, current[k]);
+        }
+    }
+    alignas(64) int32_t values[64], indexes[64];
+    for (size_t k = 0; k < 4; k++)
+    {
+        _mm512_store_si512(values  + 16 * k, best[k]);
+        _mm512_store_si512(indexes + 16 * k, index[k]);
+    }
+    return extremum_of_lanes<Maximum>(values, indexes, 64, data, i, n);
+}
+
+// Width in bits of the reduction kernels used on this CPU, 0 for the scalar fallback
+inline int reduction_kernel_bits()
+{
+    const CpuFeatures& features = cpu_features();
+    return features.avx512f ? 512 : features.avx2 ? 256 : features.sse42 ? 128 : 0;
+}
+
+inline CountFunction count_function()
+{
+    switch (reduction_kernel_bits())
+    {
+    case 512: return count_512;
+    case 256: return count_256;
+    case 128: return count_128;
+    default:  return count_scalar;
+    }
+}
+
+template <bool Maximum>
+ExtremumFunction extremum_function()
+{
+    switch (reduction_kernel_bits())
+    {
+    case 512: return extremum_512<Maximum>;
+    case 256: return extremum_256<Maximum>;
+    case 128: return extremum_128<Maximum>;
+    default:  return extremum_scalar<Maximum>;
+    }
+}
+
+// The kernels over blocks of reduction_block elements, whose indexes fit the 32-bit lanes
+inline size_t count_blocks(CountFunction count, const int32_t* data, size_t n, int32_t value)
+{
+    size_t total = 0;
+    for (size_t begin = 0; begin < n; begin += reduction_block)
+        total += count(data + begin, std::min(reduction_block, n - begin), value);
+    return total;
+}
+
+template <bool Maximum>
+size_t extremum_blocks(ExtremumFunction extremum, const int32_t* data, size_t n)
+{
+    size_t best = 0;
+    for (size_t begin = 0; begin < n; begin += reduction_block)
+    {
+        size_t found = begin + extremum(data + begin, std::min(reduction_block, n - begin));
+        if (better<Maximum>(data[found], data[best]))
+            best = found;
+    }
+    return best;
+}
+
+// Number of elements of data equal to value
+inline size_t simd_count(const int32_t* data, size_t n, int32_t value)
+{
+    return count_blocks(count_function(), data, n, value);
+}
+
+// Index of the first largest (smallest) element of data, 0 when n is 0
+inline size_t simd_max_element(const int32_t* data, size_t n)
+{
+    return n == 0 ? 0 : extremum_blocks<true>(extremum_function<true>(), data, n);
+}
+
+inline size_t simd_min_element(const int32_t* data, size_t n)
+{
+    return n == 0 ? 0 : extremum_blocks<false>(extremum_function<false>(), data, n);
+}
+
+inline size_t parallel_simd_count(const int32_t* data, size_t n, int32_t value)
+{
+    const CountFunction count  = count_function();
+    const size_t        chunks = parallel_chunk_count(n, (size_t)1 << 16);
+    std::vector<size_t> counts(chunks);
+    parallel_for_chunks(chunks, [&](size_t c)
+    {
+        auto bounds = chunk_bounds(n, chunks, c);
+        counts[c] = count_blocks(count, data + bounds.first, bounds.second - bounds.first, value);
+    });
+    size_t total = 0;
+    for (size_t c = 0; c < chunks; c++)
+        total += counts[c];
+    return total;
+}
+
+template <bool Maximum>
+size_t parallel_simd_extremum(const int32_t* data, size_t n)
+{
+    if (n == 0)
+        return 0;
+    const ExtremumFunction extremum = extremum_function<Maximum>();
+    const size_t           chunks   = parallel_chunk_count(n, (size_t)1 << 16);
+    std::vector<size_t>    found(chunks);
+    parallel_for_chunks(chunks, [&](size_t c)
+    {
+        auto bounds = chunk_bounds(n, chunks, c);
+        found[c] = bounds.first + extremum_blocks<Maximum>(extremum, data + bounds.first, bounds.second - bounds.first);
+    });
+    size_t best = found[0];
+    for (size_t c = 1; c < chunks; c++)     // in chunk order: an equal extremum of a later chunk is not first
+        if (better<Maximum>(data[found[c]], data[best]))
+            best = found[c];
+    return best;
+}
+
+inline size_t parallel_simd_max_element(const int32_t* data, size_t n)
+{
+    return parallel_simd_extremum<true>(data, n);
+}
+
+inline size_t parallel_simd_min_element(const int32_t* data, size_t n)
+{
+    return parallel_simd_extremum<false>(data, n);
+}
@@ -0,0 +1,209 @@
+// Parallel kernels writing with non-temporal (streaming) stores, which go to memory through write-combining buffers
+// without reading the destination lines first (no read for ownership) and without evicting the cache contents.
+// Stores are 128-bit (SSE2), 256-bit (AVX) or 512-bit (AVX-512F) wide, the widest cpu_features() reports.
+// The destination is split into 64-byte aligned lines, divided among the threads in chunks. The unaligned head and
+// tail are written with regular stores. Each chunk ends with an sfence, which orders its streaming stores before the
+// stores that follow on the same thread, as streaming stores are weakly ordered.
+//
+// The copy kernel only streams when the copy would not fit in the last level cache anyway: below that, regular stores
+// leave the destination cached for whoever reads it next. It prefetches the source a few lines ahead, non-temporally
+// when streaming, and uses aligned loads when the source is aligned like the destination.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include <type_traits>
+
+#include "cpu_features.h"
+#include "parallel_utils.h"
+#include "system_info.h"
+
+const size_t streaming_line_bytes        = 64;
+const size_t streaming_prefetch_distance = 8 * streaming_line_bytes;
+
+// Stores the 64-byte pattern to lines of destination, which must be 64-byte aligned
+typedef void (*StreamLinesFunction)(char* destination, size_t lines, const void* pattern);
+
+inline void stream_lines_128(char* destination, size_t lines, const void* pattern)
+{
+    __m128i value = _mm_load_si128((const __m128i*)pattern);
+    for (char* end = destination + lines * streaming_line_bytes; destination < end; destination += streaming_line_bytes)
+    {
+        _mm_stream_si128((__m128i*)destination,        value);
+        _mm_stream_si128((__m128i*)(destination + 16), value);
+        _mm_stream_si128((__m128i*)(destination + 32), value);
+        _mm_stream_si128((__m128i*)(destination + 48), value);
+    }
+}
+
+BENCHMARK_TARGET("avx")
+inline void stream_lines_256(char* destination, size_t lines, const void* pattern)
+{
+    __m256i value = _mm256_load_si256((const __m256i*)pattern);
+    for (char* end = destination + lines * streaming_line_bytes; destination < end; destination += streaming_line_bytes)
+    {
+        _mm256_stream_si256((__m256i*)destination,        value);
+        _mm256_stream_si256((__m256i*)(destination + 32), value);
+    }
+}
+
+BENCHMARK_TARGET("avx512f")
+inline void stream_lines_512(char* destination, size_t lines, const void* pattern)
+{
+    __m512i value = _mm512_load_si512(pattern);
+    for (char* end = destination + lines * streaming_line_bytes; destination < end; destination += streaming_line_bytes)
+        _mm512_stream_si512((__m512i*)destination, value);
+}
+
+// Width in bits of the streaming stores the kernels use on this CPU
+inline int streaming_store_bits()
+{
+    const CpuFeatures& features = cpu_features();
+    return features.avx512f ? 512 : features.avx ? 256 : 128;
+}
+
+inline StreamLinesFunction stream_lines_function()
+{
+    switch (streaming_store_bits())
+    {
+    case 512: return stream_lines_512;
+    case 256: return stream_lines_256;
+    default:  return stream_lines_128;
+    }
+}
+
+// Sets the n elements of data to value with streaming stores, in parallel
+template <class T>
+void parallel_fill_streaming(T* data, size_t n, T value)
+{
+    static_assert(std::is_trivially_copyable<T>::value && streaming_line_bytes % sizeof(T) == 0, "elements must tile a cache line");
+    char* begin         = (char*)data;
+    char* end           = (char*)(data + n);
+    char* aligned_begin = (char*)(((uintptr_t)begin + streaming_line_bytes - 1) & ~(uintptr_t)(streaming_line_bytes - 1));
+    char* aligned_end   = (char*)((uintptr_t)end & ~(uintptr_t)(streaming_line_bytes - 1));
+    if (aligned_begin >= aligned_end)
+    {
+        std::fill(data, data + n, value);
+        return;
+    }
+    std::fill(data, (T*)aligned_begin, value);
+    std::fill((T*)aligned_end, data + n, value);
+
+    alignas(64) T pattern[streaming_line_bytes / sizeof(T)];
+    std::fill(pattern, pattern + streaming_line_bytes / sizeof(T), value);
+    StreamLinesFunction stream = stream_lines_function();
+    const size_t lines  = (size_t)(aligned_end - aligned_begin) / streaming_line_bytes;
+    const size_t chunks = parallel_chunk_count(lines, 4096);       // at least 256 KB per chunk
+    parallel_for_chunks(chunks, [&](size_t c)
+    {
+        auto bounds = chunk_bounds(lines, chunks, c);
+        stream(aligned_begin + bounds.first * streaming_line_bytes, bounds.second - bounds.first, pattern);
+        _mm_sfence();
+    });
+}
+
+// Copies lines of source to destination, which must be 64-byte aligned. Source must be aligned to the vector width
+// when AlignedSource
+typedef void (*CopyLinesFunction)(char* destination, const char* source, size_t lines);
+
+template <bool Streaming, bool AlignedSource>
+inline void copy_lines_128(char* destination, const char* source, size_t lines)
+{
+    for (char* end = destination + lines * streaming_line_bytes; destination < end; destination += streaming_line_bytes, source += streaming_line_bytes)
+    {
+        _mm_prefetch(source + streaming_prefetch_distance, Streaming ? _MM_HINT_NTA : _MM_HINT_T0);
+        for (size_t i = 0; i < streaming_line_bytes; i += 16)
+        {
+            __m128i value = AlignedSource ? _mm_load_si128((const __m128i*)(source + i)) : _mm_loadu_si128((const __m128i*)(source + i));
+            if (Streaming)
+                _mm_stream_si128((__m128i*)(destination + i), value);
+            else
+                _mm_store_si128((__m128i*)(destination + i), value);
+        }
+    }
+}
+
+template <bool Streaming, bool AlignedSource>
+BENCHMARK_TARGET("avx")
+inline void copy_lines_256(char* destination, const char* source, size_t lines)
+{
+    for (char* end = destination + lines * streaming_line_bytes; destination < end; destination += streaming_line_bytes, source += streaming_line_bytes)
+    {
+        _mm_prefetch(source + streaming_prefetch_distance, Streaming ? _MM_HINT_NTA : _MM_HINT_T0);
+        for (size_t i = 0; i < streaming_line_bytes; i += 32)
+        {
+            __m256i value = AlignedSource ? _mm256_load_si256((const __m256i*)(source + i)) : _mm256_loadu_si256((const __m256i*)(source + i));
+            if (Streaming)
+                _mm256_stream_si256((__m256i*)(destination + i), value);
+            else
+                _mm256_store_si256((__m256i*)(destination + i), value);
+        }
+    }
+}
+
+template <bool Streaming, bool AlignedSource>
+BENCHMARK_TARGET("avx512f")
+inline void copy_lines_512(char* destination, const char* source, size_t lines)
+{
+    for (char* end = destination + lines * streaming_line_bytes; destination < end; destination += streaming_line_bytes, source += streaming_line_bytes)
+    {
+        _mm_prefetch(source + streaming_prefetch_distance, Streaming ? _MM_HINT_NTA : _MM_HINT_T0);
+        __m512i value = AlignedSource ? _mm512_load_si512(source) : _mm512_loadu_si512(source);
+        if (Streaming)
+            _mm512_stream_si512((__m512i*)destination, value);
+        else
+            _mm512_store_si512(destination, value);
+    }
+}
+
+template <bool Streaming, bool AlignedSource>
+CopyLinesFunction copy_lines_function()
+{
+    switch (streaming_store_bits())
+    {
+    case 512: return copy_lines_512<Streaming, AlignedSource>;
+    case 256: return copy_lines_256<Streaming, AlignedSource>;
+    default:  return copy_lines_128<Streaming, AlignedSource>;
+    }
+}
+
+enum StoreMode { STORES_AUTO, STORES_TEMPORAL, STORES_NONTEMPORAL };
+
+// Whether STORES_AUTO streams a copy of bytes: when source and destination together exceed the last level cache
+inline bool copy_streams(size_t bytes)
+{
+    return 2 * bytes > last_level_cache_size();
+}
+
+// Copies the n elements of source to destination, which must not overlap, in parallel
+template <class T>
+void parallel_copy_streaming(const T* source, size_t n, T* destination, StoreMode mode = STORES_AUTO)
+{
+    static_assert(std::is_trivially_copyable<T>::value && streaming_line_bytes % sizeof(T) == 0, "elements must tile a cache line");
+    size_t misalignment = (uintptr_t)destination & (streaming_line_bytes - 1);
+    size_t head         = std::min(misalignment ? (streaming_line_bytes - misalignment) / sizeof(T) : 0, n);
+    size_t lines        = (n - head) * sizeof(T) / streaming_line_bytes;
+    size_t body         = lines * streaming_line_bytes / sizeof(T);
+    std::copy(source, source + head, destination);
+    std::copy(source + head + body, source + n, destination + head + body);
+    if (lines == 0)
+        return;
+
+    bool   streaming     = mode == STORES_NONTEMPORAL || (mode == STORES_AUTO && copy_streams(n * sizeof(T)));
+    size_t vector_bytes  = (size_t)streaming_store_bits() / 8;
+    bool   aligned       = ((uintptr_t)(source + head) & (vector_bytes - 1)) == 0;
+    CopyLinesFunction copy_lines = streaming ? (aligned ? copy_lines_function<true,  true>() : copy_lines_function<true,  false>())
+                                             : (aligned ? copy_lines_function<false, true>() : copy_lines_function<false, false>());
+    char*        to     = (char*)(destination + head);
+    const char*  from   = (const char*)(source + head);
+    const size_t chunks = parallel_chunk_count(lines, 4096);
+    parallel_for_chunks(chunks, [&](size_t c)
+    {
+        auto bounds = chunk_bounds(lines, chunks, c);
+        copy_lines(to + bounds.first * streaming_line_bytes, from + bounds.first * streaming_line_bytes, bounds.second - bounds.first);
+        if (streaming)
+            _mm_sfence();
+    });
+}
@@ -0,0 +1,225 @@
+// Description of the machine the benchmarks run on: CPU model, cache hierarchy, NUMA nodes, core count and memory settings.
+// On Linux these are read from /proc and /sys. On other systems the cache list is empty and settings are "unknown".
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct CacheLevel
+{
+    int         level;      // 1, 2, 3, ...
+    std::string type;       // Data, Unified
+    size_t      size;       // bytes of one cache instance
+};
+
+inline std::string read_text_file(const std::string& path)
+{
+    std::string text;
+    FILE* file = fopen(path.c_str(), "r");
+    if (file == nullptr)
+        return text;
+    char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        text.append(buffer, count);
+    fclose(file);
+    while (!text.empty() && (text.back() == '\n' || text.back() == ' '))
+        text.pop_back();
+    return text;
+}
+
+// Data and unified caches of cpu0, from the smallest (L1d) to the largest (LLC)
+inline const std::vector<CacheLevel>& cache_levels()
+{
+    static std::vector<CacheLevel> levels = []()
+    {
+        std::vector<CacheLevel> found;
+#ifdef __linux__
+        for (int index = 0; index < 16; index++)
+        {
+            std::string directory = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+            std::string level     = read_text_file(directory + "level");
+            std::string type      = read_text_file(directory + "type");
+            std::string size      = read_text_file(directory + "size");
+            if (level.empty())
+                break;
+            if (type == "Instruction" || size.empty())
+                continue;
+            size_t bytes = std::stoull(size);
+            switch (size.back())
+            {
+            case 'K': bytes <<= 10; break;
+            case 'M': bytes <<= 20; break;
+            case 'G': bytes <<= 30; break;
+            }
+            found.push_back({ std::stoi(level), type, bytes });
+        }
+#endif
+        return found;
+    }();
+    return levels;
+}
+
+inline size_t cache_size(int level)
+{
+    for (auto& cache : cache_levels())
+        if (cache.level == level)
+            return cache.size;
+    return 0;
+}
+
+// Size of the last level cache, or a typical default when unknown
+inline size_t last_level_cache_size()
+{
+    if (cache_levels().empty())
+        return 32 * 1024 * 1024;
+    return cache_levels().back().size;
+}
+
+// Smallest cache level a working set of the given size fits in: "L1", "L2", "L3" or "DRAM"
+inline std::string cache_level_of(size_t working_set_bytes)
+{
+    if (cache_levels().empty())
+        return "unknown";
+    for (auto& cache : cache_levels())
+        if (working_set_bytes <= cache.size)
+            return "L" + std::to_string(cache.level);
+    return "DRAM";
+}
+
+struct NumaNode
+{
+    int              id;
+    std::vector<int> cpus;
+};
+
+// CPUs of a list such as "0-3,8-11"
+inline std::vector<int> parse_cpu_list(const std::string& list)
+{
+    std::vector<int> cpus;
+    size_t start = 0;
+    while (start < list.size())
+    {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos)
+            end = list.size();
+        std::string range = list.substr(start, end - start);
+        size_t      dash  = range.find('-');
+        if (!range.empty())
+        {
+            int first = std::stoi(range);
+            int last  = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++)
+                cpus.push_back(cpu);
+        }
+        start = end + 1;
+    }
+    return cpus;
+}
+
+// NUMA nodes with memory and their CPUs, from /sys/devices/system/node. Machines without NUMA information are one node
+inline const std::vector<NumaNode>& numa_nodes()
+{
+    static std::vector<NumaNode> nodes = []()
+    {
+        std::vector<NumaNode> found;
+#ifdef __linux__
+        for (int node : parse_cpu_list(read_text_file("/sys/devices/system/node/has_memory")))
+            found.push_back({ node, parse_cpu_list(read_text_file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist")) });
+#endif
+        if (found.empty())
+        {
+            found.push_back({ 0, {} });
+            for (int cpu = 0; cpu < (int)std::max(std::thread::hardware_concurrency(), 1u); cpu++)
+                found[0].cpus.push_back(cpu);
+        }
+        return found;
+    }();
+    return nodes;
+}
+
+// Such as "2 (node 0: cpus 0-15, node 1: cpus 16-31)"
+inline std::string numa_topology()
+{
+    std::string nodes;
+    for (auto& node : numa_nodes())
+    {
+        nodes += (nodes.empty() ? "" : ", ") + std::string("node ") + std::to_string(node.id) + ": cpus ";
+        std::string cpus;
+        for (size_t c = 0; c < node.cpus.size(); c++)
+        {
+            size_t run = c;
+            while (run + 1 < node.cpus.size() && node.cpus[run + 1] == node.cpus[run] + 1)
+                run++;
+            cpus += (cpus.empty() ? "" : ",") + std::to_string(node.cpus[c]) + (run > c ? "-" + std::to_string(node.cpus[run]) : "");
+            c = run;
+        }
+        nodes += cpus.empty() ? "none" : cpus;
+    }
+    return std::to_string(numa_nodes().size()) + " (" + nodes + ")";
+}
+
+inline std::string cpu_model()
+{
+#ifdef __linux__
+    std::string cpuinfo = read_text_file("/proc/cpuinfo");
+    size_t      line    = cpuinfo.find("model name");
+    if (line != std::string::npos)
+    {
+        size_t start = cpuinfo.find(':', line);
+        size_t end   = cpuinfo.find('\n', line);
+        if (start != std::string::npos && start < end)
+            return cpuinfo.substr(start + 2, end - start - 2);
+    }
+#endif
+    return "unknown";
+}
+
+// Transparent huge page mode, such as "always [madvise] never"
+inline std::string transparent_huge_pages()
+{
+    std::string mode = read_text_file("/sys/kernel/mm/transparent_hugepage/enabled");
+    return mode.empty() ? "unknown" : mode;
+}
+
+// Reserved hugetlbfs pages of each size, such as "2 MB: 512 free of 512, 1 GB: 0 free of 0"
+inline std::string huge_page_pools()
+{
+    std::string pools;
+    for (auto pool : { std::make_pair("2048kB", "2 MB"), std::make_pair("1048576kB", "1 GB") })
+    {
+        std::string directory = std::string("/sys/kernel/mm/hugepages/hugepages-") + pool.first + "/";
+        std::string total     = read_text_file(directory + "nr_hugepages");
+        if (total.empty())
+            continue;
+        pools += (pools.empty() ? "" : ", ") + std::string(pool.second) + ": " + read_text_file(directory + "free_hugepages") + " free of " + total;
+    }
+    return pools.empty() ? "unknown" : pools;
+}
+
+inline std::string cpu_frequency_governor()
+{
+    std::string governor = read_text_file("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+    return governor.empty() ? "unknown" : governor;
+}
+
+inline size_t hardware_threads()
+{
+    size_t count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+// Human readable size, such as 48 KB, 2.0 MB, 1.5 GB
+inline std::string format_bytes(double bytes)
+{
+    char text[32];
+    if      (bytes < 1024.0)                   snprintf(text, sizeof(text), "%.0f B", bytes);
+    else if (bytes < 1024.0 * 1024)            snprintf(text, sizeof(text), "%.0f KB", bytes / 1024.0);
+    else if (bytes < 1024.0 * 1024 * 1024)     snprintf(text, sizeof(text), "%.1f MB", bytes / (1024.0 * 1024));
+    else                                       snprintf(text, sizeof(text), "%.1f GB", bytes / (1024.0 * 1024 * 1024));
+    return text;
+}
@@ -0,0 +1,102 @@
+// Pinning of the threads that run the parallel policies to CPUs, so results do not depend on where the operating
+// system schedules the TBB worker threads. A tbb::task_scheduler_observer pins each thread with sched_setaffinity the
+// first time it enters the TBB scheduler (the main thread included), giving out CPUs in the order of --pin:
+//     compact  CPUs of the first NUMA node first, then of the next node, and so on
+//     spread   alternating between the NUMA nodes, for the memory bandwidth of all of them at low thread counts
+// Only available on Linux with TBB.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "system_info.h"
+
+#if defined(__linux__) && __has_include(<tbb/task_scheduler_observer.h>)
+#include <sched.h>
+#include <tbb/task_scheduler_observer.h>
+#define BENCHMARK_THREAD_PINNING
+#endif
+
+enum PinMode
+{
+    PIN_NONE,
+    PIN_COMPACT,
+    PIN_SPREAD
+};
+
+inline const char* pin_mode_name(PinMode pin)
+{
+    static const char* names[] = { "none", "compact", "spread" };
+    return names[pin];
+}
+
+inline bool parse_pin_mode(const std::string& name, PinMode& pin)
+{
+    for (PinMode mode : { PIN_NONE, PIN_COMPACT, PIN_SPREAD })
+    {
+        if (name == pin_mode_name(mode))
+        {
+            pin = mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+// CPUs in the order threads are pinned to them
+inline std::vector<int> pinning_order(PinMode pin)
+{
+    std::vector<int> cpus;
+    const std::vector<NumaNode>& nodes = numa_nodes();
+    if (pin == PIN_COMPACT)
+    {
+        for (auto& node : nodes)
+            cpus.insert(cpus.end(), node.cpus.begin(), node.cpus.end());
+    }
+    else
+    {
+        size_t most = 0;
+        for (auto& node : nodes)
+            most = std::max(most, node.cpus.size());
+        for (size_t c = 0; c < most; c++)
+            for (auto& node : nodes)
+                if (c < node.cpus.size())
+                    cpus.push_back(node.cpus[c]);
+    }
+    return cpus;
+}
+
+#ifdef BENCHMARK_THREAD_PINNING
+class ThreadPinning : public tbb::task_scheduler_observer
+{
+public:
+    explicit ThreadPinning(PinMode pin) : cpus_(pinning_order(pin))
+    {
+        if (!cpus_.empty())
+            observe(true);
+    }
+
+    ~ThreadPinning()
+    {
+        observe(false);
+    }
+
+    void on_scheduler_entry(bool /*is_worker*/) override
+    {
+        thread_local bool pinned = false;
+        if (pinned)
+            return;
+        pinned = true;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpus_[next_.fetch_add(1) % cpus_.size()], &set);
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+
+private:
+    std::vector<int>    cpus_;
+    std::atomic<size_t> next_{ 0 };
+};
+#endif